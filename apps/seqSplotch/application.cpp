@@ -27,11 +27,18 @@
  */
 
 #include "application.h"
+#include "arguments.h"
 
+#include "benchmark.h"
+#include "cameraPath.h"
 #include "model.h"
 #include "renderer.h"
+#include "stats.h"
+#include "tracer.h"
 #include "viewData.h"
 
+#include <cmath>
+
 #ifdef SEQSPLOTCH_USE_OSPRAY
 #  include <ospray/ospray.h>
 #endif
@@ -40,49 +47,142 @@ namespace seqSplotch
 {
 
 Application::Application()
+    : _stats( new Stats )
+    , _initData( new InitData )
+    , _frameData( new FrameData )
+    , _gpuUnavailable( false )
 {}
 
 Application::~Application()
 {}
 
-bool Application::init( int argc, char** argv, co::Object* initData )
+bool Application::init( int argc, char** argv, co::Object* )
 {
     std::string paramfile;
+    std::string particleFile;
+    bool benchmark = false;
+    std::string benchmarkOutput;
+    size_t benchmarkFrames = 100;
+    std::string benchmarkRenderers;
+    bool isClient = false;
     for( int i = 1; i < argc; ++i )
     {
-        if( strcmp( argv[i], "--paramfile" ) == 0 )
+        if( strcmp( argv[i], "--eq-client" ) == 0 )
+            isClient = true;
+        else if( strcmp( argv[i], "--paramfile" ) == 0 && i+1 < argc )
+            paramfile = std::string( argv[++i] );
+        else if( strcmp( argv[i], "--benchmark" ) == 0 )
+        {
+            benchmark = true;
+            if( i+1 < argc && strncmp( argv[i+1], "--", 2 ) != 0 )
+                benchmarkOutput = std::string( argv[++i] );
+        }
+        else if( strcmp( argv[i], "--benchmark-frames" ) == 0 && i+1 < argc )
+        {
+            if( !parseCount( argv[++i], benchmarkFrames ))
+            {
+                LBERROR << "Invalid --benchmark-frames " << argv[i]
+                        << std::endl;
+                return false;
+            }
+        }
+        else if( strcmp( argv[i], "--benchmark-renderers" ) == 0 &&
+                 i+1 < argc )
+        {
+            benchmarkRenderers = argv[++i];
+        }
+        else if( strcmp( argv[i], "--trace" ) == 0 && i+1 < argc )
+            Tracer::start( argv[++i] );
+        else if( strcmp( argv[i], "--record" ) == 0 && i+1 < argc )
+        {
+            _recordingFile = argv[++i];
+            _recording.reset( new CameraPath );
+        }
+        else if( strcmp( argv[i], "--write-particles" ) == 0 && i+1 < argc )
+            particleFile = argv[++i];
+        else if( strcmp( argv[i], "--playback" ) == 0 && i+1 < argc )
         {
-            ++i;
-            paramfile = std::string( argv[i] );
-            break;
+            _playback.reset( new CameraPath );
+            if( !_playback->load( argv[++i] ))
+                return false;
         }
     }
 
+#ifdef SEQSPLOTCH_USE_OSPRAY
+    ospInit( &argc, const_cast< const char** >( argv ));
+#endif
+
+    // Render clients get the model from the InitData and load only their
+    // range of it, the master does not ship any particles to them.
+    if( isClient )
+        return seq::Application::init( argc, argv, nullptr );
+
     if( paramfile.empty( ))
+    {
+        if( benchmark )
+        {
+            LBERROR << "Benchmark needs a --paramfile" << std::endl;
+            return false;
+        }
         paramfile = "/home/nachbaur/dev/viz.stable/splotch/configs/snap092.par";
+    }
 
-    _model.reset( new Model( servus::URI( paramfile )));
+    _initData->setUri( paramfile );
 
-#ifdef SEQSPLOTCH_USE_OSPRAY
-    ospInit( &argc, const_cast< const char** >( argv ));
-#endif
+    lunchbox::Clock clock;
+    _model.reset( new Model( servus::URI( paramfile ), _stats.get( )));
+    if( !_model->isValid( ))
+        return false;
+    if( !_model->canBlend() &&
+        _model->getParams().find< int >( "interpolation_steps", 1 ) > 1 )
+    {
+        LBWARN << "Ignoring interpolation_steps, the snapshots have no "
+               << "particle IDs to match them. Use interpolation_mode of "
+               << "the Splotch readers instead" << std::endl;
+    }
+    if( !particleFile.empty() &&
+        !ParticleFile::write( particleFile, _model->getParticles( )))
+    {
+        return false;
+    }
+    if( benchmark )
+    {
+        _benchmark.reset( new Benchmark( benchmarkOutput, benchmarkFrames,
+                                         _stats.get(),
+                                         std::move( _playback )));
+        _benchmark->addLoadTime( clock.getTimef( ));
+        if( !benchmarkRenderers.empty() &&
+            !_benchmark->setRenderers( benchmarkRenderers ))
+        {
+            return false;
+        }
+    }
 
 #ifdef SEQSPLOTCH_USE_ZEROEQ
     _httpServer = ::zeroeq::http::Server::parse( argc, argv );
+    if( _httpServer )
+        _httpServer->handleGET( *_stats );
 #endif
 
-    return seq::Application::init( argc, argv, initData );
+    return seq::Application::init( argc, argv, _initData.get( ));
 }
 
-bool Application::run( co::Object* frameData )
+bool Application::run( co::Object* )
 {
-    return seq::Application::run( frameData );
+    return seq::Application::run( _frameData.get( ));
 }
 
 bool Application::exit()
 {
+    if( _recording )
+        _recording->save( _recordingFile );
     _model.reset();
-    return seq::Application::exit();
+    _rangeModels.clear();
+
+    // once the pipe threads and the model loaders are gone
+    const bool result = seq::Application::exit();
+    Tracer::stop();
+    return result;
 }
 
 seq::Renderer* Application::createRenderer()
@@ -94,8 +194,11 @@ co::Object* Application::createObject( const uint32_t type )
 {
     switch( type )
     {
+      case seq::OBJECTTYPE_INITDATA:
+          return new InitData;
+
       case seq::OBJECTTYPE_FRAMEDATA:
-          return nullptr;
+          return new FrameData;
 
       default:
           return seq::Application::createObject( type );
@@ -104,7 +207,8 @@ co::Object* Application::createObject( const uint32_t type )
 
 seq::ViewData* Application::createViewData( seq::View& view )
 {
-    ViewData* viewData = new ViewData( view, _model.get( ));
+    ViewData* viewData = new ViewData( view, _model.get(), _frameData.get( ));
+    _viewDatas.push_back( viewData );
 
 #ifdef SEQSPLOTCH_USE_ZEROEQ
     if( _httpServer )
@@ -116,6 +220,9 @@ seq::ViewData* Application::createViewData( seq::View& view )
 
 void Application::destroyViewData( seq::ViewData* viewData )
 {
+    _viewDatas.erase( std::remove( _viewDatas.begin(), _viewDatas.end(),
+                                   viewData ), _viewDatas.end( ));
+
 #ifdef SEQSPLOTCH_USE_ZEROEQ
     if( _httpServer )
         _httpServer->remove( static_cast< ViewData& >( *viewData ));
@@ -124,19 +231,172 @@ void Application::destroyViewData( seq::ViewData* viewData )
     delete viewData;
 }
 
+bool Application::hasModel() const
+{
+    return _model != nullptr;
+}
+
 Model& Application::getModel()
 {
     return *_model;
 }
 
+Stats& Application::getStats()
+{
+    return *_stats;
+}
+
+size_t Application::getNumParts()
+{
+    // fine enough for the load equalizer, coarse enough that its ranges map
+    // to a few models
+    return 64;
+}
+
+std::shared_ptr< Model > Application::getRangeModel( const std::string& uri,
+                                                     const size_t first,
+                                                     const size_t last )
+{
+    std::lock_guard< std::mutex > lock( _rangeModelsMutex );
+    for( const RangeModel& rangeModel : _rangeModels )
+        if( rangeModel.first == first && rangeModel.last == last )
+            return rangeModel.model;
+
+    const seq::Vector2f range( float( first ) / float( getNumParts( )),
+                               float( last ) / float( getNumParts( )));
+    LBINFO << "Loading particle range [" << range.x() << ", " << range.y()
+           << "] of " << uri << std::endl;
+
+    // the Splotch readers load whole snapshots, once for all ranges
+    const servus::URI modelURI( uri );
+    std::shared_ptr< SceneCache > sceneCache;
+    if( !SyntheticSource::isSynthetic( modelURI ) &&
+        !ParticleFile::isParticleFile( modelURI ))
+    {
+        sceneCache = _sceneCache.lock();
+        if( !sceneCache )
+        {
+            sceneCache = std::make_shared< SceneCache >( modelURI );
+            _sceneCache = sceneCache;
+        }
+    }
+    _rangeModels.push_back( RangeModel{ first, last, std::make_shared< Model >(
+                                modelURI, _stats.get(), range, sceneCache )});
+    return _rangeModels.back().model;
+}
+
+void Application::releaseRangeModel( std::shared_ptr< Model >& model )
+{
+    std::lock_guard< std::mutex > lock( _rangeModelsMutex );
+    model.reset();
+    _rangeModels.erase( std::remove_if( _rangeModels.begin(),
+                                        _rangeModels.end(),
+        []( const RangeModel& rangeModel )
+        { return rangeModel.model.use_count() == 1; }), _rangeModels.end( ));
+}
+
+void Application::updateRangeModel( Model& model, const FrameData& frameData )
+{
+    // the first pipe loads, the others find the model at the frame already
+    std::lock_guard< std::mutex > lock( _rangeModelsMutex );
+    model.setFrameTime( frameData.getFrameIndex(), frameData.getBlend( ));
+    model.prefetch( frameData.getPrefetchIndex( ));
+}
+
+void Application::setGPUUnavailable()
+{
+    _gpuUnavailable = true;
+}
+
+void Application::_updateFrameData()
+{
+    // the render clients follow the frame of the master model, which has
+    // the next one loaded already while blending towards it
+    const uint64_t frame = _model->getFrameIndex();
+    const uint64_t prefetch = frame + ( _frameData->getBlend() > 0.f ? 2 : 1 );
+    if( _frameData->getFrameIndex() != frame ||
+        _frameData->getPrefetchIndex() != prefetch )
+    {
+        _frameData->setFrameIndex( frame );
+        _frameData->setPrefetchIndex( prefetch );
+    }
+    _model->prefetch( prefetch );
+
+    // the renderers start their pipe frames on the frame ID, a new version
+    if( !_viewDatas.empty( ))
+    {
+        const eq::Config* config = _viewDatas.front()->getView().getConfig();
+        _frameData->setFrameNumber( config->getCurrentFrame() + 1 );
+    }
+}
+
+void Application::_advanceFrame()
+{
+    // interpolation_steps display frames per snapshot, blended by the models
+    const size_t steps = !_model->canBlend() ? 1 :
+        size_t( std::max( _model->getParams().find< int >(
+                              "interpolation_steps", 1 ), 1 ));
+    const size_t step = size_t( std::lround( _frameData->getBlend() *
+                                             float( steps ))) + 1;
+    if( step >= steps )
+    {
+        _model->loadNextFrame();
+        _frameData->setBlend( 0.f );
+    }
+    else
+        _frameData->setBlend( float( step ) / float( steps ));
+    _model->setFrameTime( _model->getFrameIndex(), _frameData->getBlend( ));
+}
+
 bool Application::handleEvents()
 {
-#ifdef SEQSPLOTCH_USE_ZEROEQ
+    // the pipes may still draw the frames the model drops from now on
+    if( !_viewDatas.empty( ))
+    {
+        const eq::Config* config = _viewDatas.front()->getView().getConfig();
+        _model->syncFrames( config->getCurrentFrame(),
+                            config->getFinishedFrame( ));
+    }
+
     bool redraw = false;
+    if( _benchmark && !_viewDatas.empty( ))
+    {
+        if( _gpuUnavailable )
+            _benchmark->skipRenderer( serializable::RendererType::GPU );
+        ViewData& viewData = *_viewDatas.front();
+        if( _benchmark->step( viewData, *_model ))
+            redraw = true;
+        else
+        {
+            _benchmark.reset();
+            viewData.getView().getConfig()->stopRunning();
+        }
+    }
+
+    if( _playback && !_viewDatas.empty( ))
+    {
+        if( _playback->play( *_viewDatas.front(), *_model ))
+            redraw = true;
+        else
+            _playback.reset();
+    }
+
+#ifdef SEQSPLOTCH_USE_ZEROEQ
     while( _httpServer && _httpServer->receive( 0 ))
         redraw = true;
-    return redraw;
 #endif
+
+    if( _frameData->getPlaying( ))
+    {
+        _advanceFrame();
+        redraw = true;
+    }
+    _updateFrameData();
+
+    // after all changes, so the state of the next frame is recorded
+    if( _recording && !_viewDatas.empty( ))
+        _recording->record( *_viewDatas.front(), *_model );
+    return redraw;
 }
 
 }
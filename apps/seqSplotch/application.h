@@ -37,9 +37,18 @@
 
 #include "types.h"
 
+#include "serializables/frameData.h"
+#include "serializables/initData.h"
+
+#include <atomic>
+#include <mutex>
+
 namespace seqSplotch
 {
 
+typedef co::Distributable< serializable::FrameData > FrameData;
+typedef co::Distributable< serializable::InitData > InitData;
+
 class Application : public seq::Application
 {
 public:
@@ -53,15 +62,67 @@ public:
     seq::Renderer* createRenderer()  final;
     co::Object* createObject( const uint32_t type ) final;
 
+    /**
+     * @return false on render clients, they load the particles of their
+     *         range themselves from InitData::getUri().
+     */
+    bool hasModel() const;
     Model& getModel();
+    Stats& getStats();
+
+    /** @return the number of equal parts DB ranges are rounded to. */
+    static size_t getNumParts();
+
+    /**
+     * @return the model of the [first, last) parts of the data, loaded on
+     *         first use and shared by all pipes of this process. Thread safe.
+     */
+    std::shared_ptr< Model > getRangeModel( const std::string& uri,
+                                            size_t first, size_t last );
+
+    /** Drop a model of getRangeModel(), freed if no pipe uses it. */
+    void releaseRangeModel( std::shared_ptr< Model >& model );
+
+    /**
+     * Move a model of getRangeModel() to the frame of the master, once for
+     * all pipes drawing it. Thread safe.
+     */
+    void updateRangeModel( Model& model, const FrameData& frameData );
+
+    /**
+     * Called by the pipes of this process without OpenGL 4.3, the benchmark
+     * skips the GPU renderer then. Thread safe.
+     */
+    void setGPUUnavailable();
 
 private:
     seq::ViewData* createViewData( seq::View& view ) final;
     void destroyViewData( seq::ViewData* viewData ) final;
 
     bool handleEvents() final;
+    void _updateFrameData();
+    void _advanceFrame();
 
+    std::unique_ptr< Stats > _stats;
+    std::unique_ptr< InitData > _initData;
+    std::unique_ptr< FrameData > _frameData;
     std::unique_ptr< Model > _model;
+    std::unique_ptr< Benchmark > _benchmark;
+    std::atomic< bool > _gpuUnavailable;
+    std::unique_ptr< CameraPath > _recording;
+    std::string _recordingFile;
+    std::unique_ptr< CameraPath > _playback;
+    std::vector< ViewData* > _viewDatas;
+
+    struct RangeModel
+    {
+        size_t first;
+        size_t last;
+        std::shared_ptr< Model > model;
+    };
+    std::mutex _rangeModelsMutex;
+    std::vector< RangeModel > _rangeModels;
+    std::weak_ptr< SceneCache > _sceneCache; // of the range models
 
 #ifdef SEQSPLOTCH_USE_ZEROEQ
     std::unique_ptr< ::zeroeq::http::Server > _httpServer;
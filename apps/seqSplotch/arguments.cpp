@@ -0,0 +1,80 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arguments.h"
+
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+
+namespace seqSplotch
+{
+
+bool parseCount( const std::string& value, size_t& count )
+{
+    // strtoull skips spaces and wraps negative numbers around
+    if( value.empty() || !std::isdigit( static_cast< unsigned char >(
+                                            value[0] )))
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull( value.c_str(), &end,
+                                                     10 );
+    if( *end != '\0' || errno == ERANGE || parsed > SIZE_MAX )
+        return false;
+    count = size_t( parsed );
+    return true;
+}
+
+bool parseResolution( const std::string& value, int& width, int& height )
+{
+    const size_t pos = value.find( 'x' );
+    size_t newWidth = 0;
+    size_t newHeight = size_t( height );
+    if( !parseCount( value.substr( 0, pos ), newWidth ) ||
+        ( pos != std::string::npos &&
+          !parseCount( value.substr( pos + 1 ), newHeight )))
+    {
+        return false;
+    }
+    if( newWidth == 0 || newHeight == 0 || newWidth > INT_MAX ||
+        newHeight > INT_MAX )
+    {
+        return false;
+    }
+    width = int( newWidth );
+    height = int( newHeight );
+    return true;
+}
+
+}
@@ -0,0 +1,172 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "application.h"
+#include "arguments.h"
+#include "configWriter.h"
+#include "model.h"
+
+#ifdef SEQSPLOTCH_USE_QT5WIDGETS
+#  include <QApplication>
+#  include <QScopedPointer>
+#endif
+
+#ifdef __linux__
+#  include <X11/Xlib.h>
+#endif
+
+#include <algorithm>
+#include <unistd.h>
+
+namespace
+{
+// offscreen FBO channels, no latency so frame times are not overlapped
+std::string _writeConfig( const std::string& paramfile,
+                          const size_t numClients,
+                          const seqSplotch::ConfigWriter::Decomposition mode,
+                          const bool balance, const int width,
+                          const int height )
+{
+    seqSplotch::ConfigWriter writer( numClients, mode, width, height );
+    writer.setBalance( balance );
+    if( numClients > 0 && !paramfile.empty( ))
+    {
+        // a sample of the particles is plenty for the cost model
+        seqSplotch::Model model( servus::URI( paramfile ), nullptr,
+                                 seq::Vector2f( 0.f, 1.f / 16.f ));
+        writer.seed( model );
+    }
+
+    const std::string filename = "/tmp/seqSplotchBench." +
+                                 std::to_string( ::getpid( )) + ".eqc";
+    return writer.write( filename ) ? filename : std::string();
+}
+}
+
+int main( int argc, char** argv )
+{
+    std::vector< std::string > args( argv, argv + argc );
+    int width = 1920;
+    int height = 1080;
+    bool hasConfig = false;
+    bool hasBenchmark = false;
+    std::string paramfile;
+    size_t numClients = 0;
+    auto decomposition = seqSplotch::ConfigWriter::DECOMPOSITION_2D;
+    bool balance = false;
+    for( size_t i = 1; i < args.size(); ++i )
+    {
+        // render clients get their configuration from the server
+        if( args[i] == "--eq-config" || args[i] == "--eq-client" )
+            hasConfig = true;
+        else if( args[i] == "--paramfile" && i+1 < args.size( ))
+            paramfile = args[++i];
+        else if( args[i] == "--clients" && i+1 < args.size( ))
+        {
+            if( !seqSplotch::parseCount( args[++i], numClients ))
+            {
+                LBERROR << "Invalid --clients " << args[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if( args[i] == "--decomposition" && i+1 < args.size( ))
+        {
+            ++i;
+            if( args[i] == "DB" )
+                decomposition = seqSplotch::ConfigWriter::DECOMPOSITION_DB;
+            else if( args[i] == "STEREO" )
+                decomposition = seqSplotch::ConfigWriter::DECOMPOSITION_STEREO;
+        }
+        else if( args[i] == "--balance" )
+            balance = true;
+        else if( args[i] == "--benchmark" )
+            hasBenchmark = true;
+        else if( args[i] == "--resolution" && i+1 < args.size( ))
+        {
+            if( !seqSplotch::parseResolution( args[++i], width, height ))
+            {
+                LBERROR << "Invalid --resolution " << args[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Splotch images are tone-mapped and have no depth, they can't be
+    // composited sort-last
+    if( decomposition == seqSplotch::ConfigWriter::DECOMPOSITION_DB )
+    {
+        const auto renderers = std::find( args.begin(), args.end(),
+                                          "--benchmark-renderers" );
+        if( renderers == args.end() || renderers + 1 == args.end( ))
+        {
+            args.push_back( "--benchmark-renderers" );
+            args.push_back( "GPU,OSPRAY" );
+        }
+        else if( renderers[1].find( "SPLOTCH" ) != std::string::npos )
+        {
+            LBERROR << "The Splotch renderers can't run a DB decomposition"
+                    << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::string config;
+    if( !hasConfig )
+    {
+        config = _writeConfig( paramfile, numClients, decomposition, balance,
+                               width, height );
+        if( config.empty( ))
+            return EXIT_FAILURE;
+        args.push_back( "--eq-config" );
+        args.push_back( config );
+    }
+    if( !hasBenchmark )
+        args.push_back( "--benchmark" );
+
+    std::vector< char* > newArgv;
+    for( std::string& arg : args )
+        newArgv.push_back( &arg[0] );
+    newArgv.push_back( nullptr );
+    int newArgc = int( args.size( ));
+
+    lunchbox::RefPtr< seqSplotch::Application > app( new seqSplotch::Application );
+
+#ifdef SEQSPLOTCH_USE_QT5WIDGETS
+#  ifdef __linux__
+        ::XInitThreads();
+#  endif
+    QScopedPointer< QApplication > qtApp( new QApplication( newArgc,
+                                                            newArgv.data( )));
+#endif
+
+    const bool success = app->init( newArgc, newArgv.data(), nullptr ) &&
+                         app->run( nullptr ) && app->exit();
+    if( !config.empty( ))
+        ::unlink( config.c_str( ));
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
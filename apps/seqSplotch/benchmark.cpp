@@ -0,0 +1,274 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "benchmark.h"
+
+#include "cameraPath.h"
+#include "model.h"
+#include "stats.h"
+#include "viewData.h"
+
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+namespace seqSplotch
+{
+namespace
+{
+const char* _getName( const serializable::RendererType type )
+{
+    switch( type )
+    {
+    case serializable::RendererType::GPU:
+        return "GPU";
+    case serializable::RendererType::SPLOTCH_OLD:
+        return "SPLOTCH_OLD";
+    case serializable::RendererType::SPLOTCH_NEW:
+        return "SPLOTCH_NEW";
+    case serializable::RendererType::OSPRAY:
+        return "OSPRAY";
+    }
+    return "UNKNOWN";
+}
+
+float _getPercentile( std::vector< float > values, const float percentile )
+{
+    if( values.empty( ))
+        return 0.f;
+    std::sort( values.begin(), values.end( ));
+    const size_t index = size_t( percentile * float( values.size( )));
+    return values[std::min( index, values.size() - 1 )];
+}
+}
+
+Benchmark::Benchmark( const std::string& output, const size_t numFrames,
+                      Stats* stats, std::unique_ptr< CameraPath > path )
+    : _output( output )
+    , _stats( stats )
+    , _path( std::move( path ))
+    , _numFrames( std::max( _path ? _path->getNumFrames() : numFrames,
+                            size_t( 1 )))
+    , _numWarmupFrames( 2 )
+    , _frame( 0 )
+    , _loadTime( 0.f )
+{
+    _renderers.push_back( int( serializable::RendererType::GPU ));
+    _renderers.push_back( int( serializable::RendererType::SPLOTCH_OLD ));
+    _renderers.push_back( int( serializable::RendererType::SPLOTCH_NEW ));
+#ifdef SEQSPLOTCH_USE_OSPRAY
+    _renderers.push_back( int( serializable::RendererType::OSPRAY ));
+#endif
+}
+
+Benchmark::~Benchmark()
+{}
+
+bool Benchmark::step( ViewData& viewData, Model& model )
+{
+    // called once per frame, the time since the last call is the time of the
+    // frame set up by the last call
+    const float frameTime = _clock.resetTimef();
+    const size_t framesPerRenderer = _numWarmupFrames + _numFrames;
+    if( _frame > 0 && ( _frame - 1 ) % framesPerRenderer >= _numWarmupFrames )
+    {
+        Result& result = _results.back();
+        result.frameTimes.push_back( frameTime );
+        if( _stats && result.frameTimes.size() == _numFrames )
+        {
+            result.drawTime = _stats->getMedian( Stats::STAGE_FRAME );
+            for( size_t stage = 0; stage < Stats::STAGE_ALL; ++stage )
+                result.stages[stage] =
+                    _stats->getSamples( Stats::Stage( stage ));
+        }
+    }
+
+    if( _frame == _renderers.size() * framesPerRenderer )
+    {
+        _write();
+        return false;
+    }
+
+    if( _frame % framesPerRenderer == 0 )
+    {
+        const auto type = serializable::RendererType(
+                              _renderers[_frame / framesPerRenderer] );
+        _results.push_back( Result{ _getName( type ),
+                                    model.getParticles().size(),
+                                    std::vector< float >(), 0.f });
+        viewData.setRenderer( type );
+    }
+
+    // draw times of the measured frames only
+    if( _stats && _frame % framesPerRenderer == _numWarmupFrames )
+        _stats->clear();
+
+    _setCamera( viewData, model );
+    ++_frame;
+    return true;
+}
+
+void Benchmark::addLoadTime( const float milliseconds )
+{
+    _loadTime += milliseconds;
+}
+
+bool Benchmark::setRenderers( const std::string& names )
+{
+    const serializable::RendererType types[] = {
+        serializable::RendererType::GPU,
+        serializable::RendererType::SPLOTCH_OLD,
+        serializable::RendererType::SPLOTCH_NEW,
+        serializable::RendererType::OSPRAY };
+
+    std::vector< int > renderers;
+    std::istringstream is( names );
+    std::string name;
+    while( std::getline( is, name, ',' ))
+    {
+        const auto type = std::find_if( std::begin( types ), std::end( types ),
+            [&name]( const serializable::RendererType candidate )
+            { return name == _getName( candidate ); });
+        if( type == std::end( types ))
+        {
+            LBERROR << "Unknown renderer " << name << std::endl;
+            return false;
+        }
+        if( std::find( _renderers.begin(), _renderers.end(),
+                       int( *type )) != _renderers.end( ))
+        {
+            renderers.push_back( int( *type ));
+        }
+    }
+    _renderers = renderers; // the available ones
+    return true;
+}
+
+void Benchmark::skipRenderer( const serializable::RendererType type )
+{
+    const auto i = std::find( _renderers.begin(), _renderers.end(),
+                              int( type ));
+    if( _frame > 0 || i == _renderers.end( ))
+        return;
+
+    LBWARN << "Skipping the " << _getName( type ) << " renderer, a pipe does "
+           << "not support it" << std::endl;
+    _renderers.erase( i );
+}
+
+void Benchmark::_setCamera( ViewData& viewData, Model& model ) const
+{
+    const size_t frame = _frame % ( _numWarmupFrames + _numFrames );
+    if( _path && _path->getNumFrames() > 0 )
+    {
+        // warm up on the first frame, the renderer is set by the benchmark
+        const CameraPath::Frame& pathFrame = _path->getFrame(
+            frame < _numWarmupFrames ? 0 : frame - _numWarmupFrames );
+        viewData.setModelMatrix( pathFrame.modelMatrix );
+        model.setFrameIndex( pathFrame.modelFrame );
+        return;
+    }
+
+    // orbit once around the model center, after the warmup frames
+    const float angle = frame < _numWarmupFrames ? 0.f :
+                        2.f * float( M_PI ) * float( frame - _numWarmupFrames ) /
+                        float( _numFrames );
+
+    const seq::Vector4f& sphere = model.getBoundingSphere();
+    seq::Matrix4f toCenter( seq::Matrix4f::IDENTITY );
+    seq::Matrix4f fromCenter( seq::Matrix4f::IDENTITY );
+    seq::Matrix4f rotation( seq::Matrix4f::IDENTITY );
+    for( size_t i = 0; i < 3; ++i )
+    {
+        toCenter( i, 3 ) = -sphere[i];
+        fromCenter( i, 3 ) = sphere[i];
+    }
+    rotation( 0, 0 ) = std::cos( angle );
+    rotation( 0, 2 ) = std::sin( angle );
+    rotation( 2, 0 ) = -std::sin( angle );
+    rotation( 2, 2 ) = std::cos( angle );
+
+    viewData.setModelMatrix( model.getModelMatrix() * fromCenter * rotation *
+                             toCenter );
+}
+
+void Benchmark::_write() const
+{
+    std::ofstream file;
+    if( !_output.empty( ))
+        file.open( _output.c_str( ));
+    std::ostream& os = _output.empty() ? std::cout : file;
+
+    os << "{" << std::endl
+       << "  \"loadTime\": " << _loadTime << "," << std::endl
+       << "  \"renderers\": [" << std::endl;
+    for( size_t i = 0; i < _results.size(); ++i )
+    {
+        const Result& result = _results[i];
+        const float sum = std::accumulate( result.frameTimes.begin(),
+                                           result.frameTimes.end(), 0.f );
+        const float mean = result.frameTimes.empty() ? 0.f :
+                               sum / float( result.frameTimes.size( ));
+        const float fps = mean > 0.f ? 1000.f / mean : 0.f;
+
+        os << "    {" << std::endl
+           << "      \"name\": \"" << result.renderer << "\"," << std::endl
+           << "      \"frames\": " << result.frameTimes.size() << ","
+           << std::endl
+           << "      \"particles\": " << result.particles << "," << std::endl
+           << "      \"frameTime\": { \"mean\": " << mean
+           << ", \"p50\": " << _getPercentile( result.frameTimes, .5f )
+           << ", \"p95\": " << _getPercentile( result.frameTimes, .95f )
+           << ", \"max\": " << _getPercentile( result.frameTimes, 1.f )
+           << " }," << std::endl
+           << "      \"drawTime\": " << result.drawTime << "," << std::endl
+           << "      \"stages\": {";
+        bool first = true;
+        for( size_t stage = 0; stage < Stats::STAGE_ALL; ++stage )
+        {
+            const std::vector< float >& samples = result.stages[stage];
+            if( samples.empty( ))
+                continue;
+            os << ( first ? "" : "," ) << std::endl
+               << "        \"" << Stats::getName( Stats::Stage( stage ))
+               << "\": { \"count\": " << samples.size()
+               << ", \"p50\": " << _getPercentile( samples, .5f )
+               << ", \"p95\": " << _getPercentile( samples, .95f )
+               << ", \"max\": " << _getPercentile( samples, 1.f ) << " }";
+            first = false;
+        }
+        os << std::endl << "      }," << std::endl
+           << "      \"fps\": " << fps << "," << std::endl
+           << "      \"particlesPerSecond\": " << fps * result.particles
+           << std::endl
+           << "    }" << ( i + 1 < _results.size() ? "," : "" ) << std::endl;
+    }
+    os << "  ]" << std::endl << "}" << std::endl;
+}
+
+}
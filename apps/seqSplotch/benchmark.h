@@ -0,0 +1,116 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_BENCHMARK_H
+#define SEQ_SPLOTCH_BENCHMARK_H
+
+#include <seq/sequel.h>
+
+#include "stats.h"
+#include "types.h"
+
+#include "serializables/viewData.h"
+
+#include <array>
+
+namespace seqSplotch
+{
+
+/**
+ * Drives a view through a camera path once per renderer type and reports the
+ * timings as JSON. The path is an orbit around the model or a recorded one.
+ */
+class Benchmark
+{
+public:
+    /**
+     * @param output the JSON file to write, stdout if empty
+     * @param numFrames the number of measured frames per renderer
+     * @param stats optional, the draw times of the local channels
+     * @param path the recorded path to follow instead of the orbit, its
+     *             length overrides numFrames
+     */
+    Benchmark( const std::string& output, size_t numFrames,
+               Stats* stats = nullptr,
+               std::unique_ptr< CameraPath > path = nullptr );
+    ~Benchmark();
+
+    /**
+     * Advance to the next frame of the benchmark.
+     *
+     * @return false once all renderers have been measured.
+     */
+    bool step( ViewData& viewData, Model& model );
+
+    /** Record the time spent loading data outside of the frame loop. */
+    void addLoadTime( float milliseconds );
+
+    /**
+     * Measure only the given renderers, a comma-separated list of GPU,
+     * SPLOTCH_OLD, SPLOTCH_NEW and OSPRAY.
+     *
+     * @return false if a name is unknown.
+     */
+    bool setRenderers( const std::string& names );
+
+    /**
+     * Do not measure a renderer which a pipe does not support. Has no effect
+     * after the first step().
+     */
+    void skipRenderer( serializable::RendererType type );
+
+private:
+    struct Result
+    {
+        std::string renderer;
+        size_t particles;
+        std::vector< float > frameTimes;
+        float drawTime; // median of the local channels
+        // samples of the local channels per stage
+        std::array< std::vector< float >, Stats::STAGE_ALL > stages;
+    };
+
+    void _setCamera( ViewData& viewData, Model& model ) const;
+    void _write() const;
+
+    const std::string _output;
+    Stats* const _stats;
+    std::unique_ptr< CameraPath > _path;
+    const size_t _numFrames;
+    const size_t _numWarmupFrames;
+
+    std::vector< int > _renderers;
+    std::vector< Result > _results;
+    size_t _frame;
+    float _loadTime;
+    lunchbox::Clock _clock;
+};
+
+}
+
+#endif
@@ -0,0 +1,182 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cameraPath.h"
+
+#include "model.h"
+#include "viewData.h"
+
+#include <fstream>
+
+namespace seqSplotch
+{
+namespace
+{
+const char _magic[4] = { 'S', 'Q', 'C', 'P' };
+const uint32_t _version = 1;
+// matrix, model frame, renderer, blur strength and blur
+const uint64_t _frameSize = 16 * sizeof( float ) + sizeof( uint64_t ) +
+                            sizeof( uint32_t ) + sizeof( float ) +
+                            sizeof( uint32_t );
+
+template< class T > void _write( std::ostream& os, const T& value )
+{
+    os.write( reinterpret_cast< const char* >( &value ), sizeof( T ));
+}
+
+template< class T > void _read( std::istream& is, T& value )
+{
+    is.read( reinterpret_cast< char* >( &value ), sizeof( T ));
+}
+}
+
+bool CameraPath::Frame::operator == ( const Frame& rhs ) const
+{
+    return modelMatrix == rhs.modelMatrix && modelFrame == rhs.modelFrame &&
+           renderer == rhs.renderer && blurStrength == rhs.blurStrength &&
+           blur == rhs.blur;
+}
+
+CameraPath::CameraPath()
+    : _current( 0 )
+{
+}
+
+bool CameraPath::load( const std::string& filename )
+{
+    std::ifstream file( filename.c_str(), std::ios::binary );
+    char magic[4] = { 0 };
+    uint32_t version = 0;
+    uint64_t numFrames = 0;
+    file.read( magic, sizeof( magic ));
+    _read( file, version );
+    _read( file, numFrames );
+    if( !file || !std::equal( magic, magic + 4, _magic ) ||
+        version != _version )
+    {
+        LBERROR << "Can't read camera path " << filename << std::endl;
+        return false;
+    }
+
+    // the count comes from the file, don't allocate more than it holds
+    const std::streamoff header = file.tellg();
+    file.seekg( 0, std::ios::end );
+    const uint64_t remaining = uint64_t( file.tellg() - header );
+    file.seekg( header );
+    if( !file || numFrames > remaining / _frameSize )
+    {
+        LBERROR << "Truncated camera path " << filename << std::endl;
+        return false;
+    }
+
+    _frames.resize( numFrames );
+    for( Frame& frame : _frames )
+    {
+        uint32_t blur = 0;
+        file.read( reinterpret_cast< char* >( frame.modelMatrix.data( )),
+                   16 * sizeof( float ));
+        _read( file, frame.modelFrame );
+        _read( file, frame.renderer );
+        _read( file, frame.blurStrength );
+        _read( file, blur );
+        frame.blur = blur != 0;
+    }
+    _current = 0;
+
+    if( !file )
+    {
+        LBERROR << "Truncated camera path " << filename << std::endl;
+        _frames.clear();
+        return false;
+    }
+    return true;
+}
+
+bool CameraPath::save( const std::string& filename ) const
+{
+    std::ofstream file( filename.c_str(), std::ios::binary );
+    file.write( _magic, sizeof( _magic ));
+    _write( file, _version );
+    _write( file, uint64_t( _frames.size( )));
+    for( const Frame& frame : _frames )
+    {
+        file.write( reinterpret_cast< const char* >( frame.modelMatrix.data( )),
+                    16 * sizeof( float ));
+        _write( file, frame.modelFrame );
+        _write( file, frame.renderer );
+        _write( file, frame.blurStrength );
+        _write( file, uint32_t( frame.blur ));
+    }
+
+    if( !file )
+    {
+        LBERROR << "Can't write camera path " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void CameraPath::record( const ViewData& viewData, const Model& model )
+{
+    const Frame frame{ viewData.getModelMatrix(), model.getFrameIndex(),
+                       uint32_t( viewData.getRenderer( )),
+                       viewData.getBlurStrength(), viewData.getBlur() };
+    if( _frames.empty() || !( _frames.back() == frame ))
+        _frames.push_back( frame );
+}
+
+bool CameraPath::play( ViewData& viewData, Model& model )
+{
+    if( _current >= _frames.size( ))
+        return false;
+
+    const Frame& frame = _frames[_current++];
+    viewData.setModelMatrix( frame.modelMatrix );
+    model.setFrameIndex( frame.modelFrame );
+    viewData.setRenderer( serializable::RendererType( frame.renderer ));
+    viewData.setBlur( frame.blur );
+    viewData.setBlurStrength( frame.blurStrength );
+    return true;
+}
+
+void CameraPath::rewind()
+{
+    _current = 0;
+}
+
+size_t CameraPath::getNumFrames() const
+{
+    return _frames.size();
+}
+
+const CameraPath::Frame& CameraPath::getFrame( const size_t index ) const
+{
+    return _frames[index];
+}
+
+}
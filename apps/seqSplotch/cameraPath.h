@@ -0,0 +1,88 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_CAMERAPATH_H
+#define SEQ_SPLOTCH_CAMERAPATH_H
+
+#include <seq/sequel.h>
+
+#include "types.h"
+
+namespace seqSplotch
+{
+
+/**
+ * A recorded session: model matrix, renderer, model frame and blur settings
+ * for each rendered frame, stored in a compact binary file.
+ */
+class CameraPath
+{
+public:
+    struct Frame
+    {
+        seq::Matrix4f modelMatrix;
+        uint64_t modelFrame;
+        uint32_t renderer;
+        float blurStrength;
+        bool blur;
+
+        bool operator == ( const Frame& rhs ) const;
+    };
+
+    CameraPath();
+
+    /** Load a path saved by save(), @return false on error. */
+    bool load( const std::string& filename );
+
+    /** @return false if the file could not be written. */
+    bool save( const std::string& filename ) const;
+
+    /** Append the current state, unless it is the same as the last frame. */
+    void record( const ViewData& viewData, const Model& model );
+
+    /**
+     * Apply the next frame of the path to the view and the model.
+     *
+     * @return false after the last frame.
+     */
+    bool play( ViewData& viewData, Model& model );
+
+    /** Restart play() at the first frame. */
+    void rewind();
+
+    size_t getNumFrames() const;
+    const Frame& getFrame( size_t index ) const;
+
+private:
+    std::vector< Frame > _frames;
+    size_t _current;
+};
+
+}
+
+#endif
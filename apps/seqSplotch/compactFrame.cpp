@@ -0,0 +1,309 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compactFrame.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace seqSplotch
+{
+namespace
+{
+const float _maxPosition = 65535.f;
+const float _maxColor = 255.f;
+
+uint16_t _toHalf( const float value )
+{
+    uint32_t bits;
+    std::memcpy( &bits, &value, sizeof( bits ));
+    const uint16_t sign = ( bits >> 16 ) & 0x8000;
+    const int32_t exponent = int32_t(( bits >> 23 ) & 0xff ) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if((( bits >> 23 ) & 0xff ) == 0xff ) // inf and nan
+        return sign | 0x7c00 | ( mantissa ? 0x200 : 0 );
+    if( exponent >= 31 )
+        return sign | 0x7c00;
+    if( exponent <= 0 ) // denormalized or zero
+    {
+        if( exponent < -10 )
+            return sign;
+        mantissa |= 0x800000;
+        const uint32_t shift = 14 - exponent;
+        const uint16_t half = mantissa >> shift;
+        return sign | ( half + (( mantissa >> ( shift - 1 )) & 1 ));
+    }
+    // rounding may carry into the exponent, which is still correct
+    const uint16_t half = sign | ( exponent << 10 ) | ( mantissa >> 13 );
+    return half + (( mantissa >> 12 ) & 1 );
+}
+
+float _fromHalf( const uint16_t half )
+{
+    const uint32_t sign = uint32_t( half & 0x8000 ) << 16;
+    const uint32_t exponent = ( half >> 10 ) & 0x1f;
+    const uint32_t mantissa = half & 0x3ff;
+
+    if( exponent == 0 )
+    {
+        const float value = std::ldexp( float( mantissa ), -24 );
+        return sign ? -value : value;
+    }
+
+    const uint32_t bits = exponent == 31 ?
+                          sign | 0x7f800000 | ( mantissa << 13 ) :
+                          sign | (( exponent + 127 - 15 ) << 23 ) |
+                              ( mantissa << 13 );
+    float value;
+    std::memcpy( &value, &bits, sizeof( value ));
+    return value;
+}
+
+float _getScale( const float min, const float max, const float steps )
+{
+    return max > min ? ( max - min ) / steps : 0.f;
+}
+
+uint16_t _quantize( const float value, const float origin, const float scale,
+                    const float steps )
+{
+    if( scale == 0.f )
+        return 0;
+    const float step = ( value - origin ) / scale + .5f;
+    return uint16_t( std::max( 0.f, std::min( step, steps )));
+}
+
+// @return the previous column if it has the same content
+template< class T >
+std::shared_ptr< const std::vector< T > > _share(
+    const std::shared_ptr< std::vector< T > >& column,
+    const std::shared_ptr< const std::vector< T > >& previous )
+{
+    if( previous && previous->size() == column->size() &&
+        std::memcmp( previous->data(), column->data(),
+                     column->size() * sizeof( T )) == 0 )
+    {
+        return previous;
+    }
+    return column;
+}
+}
+
+CompactFrame::CompactFrame()
+    : _colorOrigin( 0.f )
+    , _colorScale( 0.f )
+{
+}
+
+size_t CompactFrame::getParticleSize()
+{
+    return sizeof( Position ) + 2 * sizeof( uint16_t ) + 2 * sizeof( uint8_t );
+}
+
+void CompactFrame::encode( const Particles& particles )
+{
+    const int64_t numParticles = particles.size();
+    const float max = std::numeric_limits< float >::max();
+    vec3 lower( max, max, max );
+    vec3 upper( -max, -max, -max );
+    float colorLower = max;
+    float colorUpper = -max;
+
+#pragma omp parallel
+    {
+        vec3 localLower( lower ), localUpper( upper );
+        float localColorLower = colorLower, localColorUpper = colorUpper;
+#pragma omp for schedule( static )
+        for( int64_t i = 0; i < numParticles; ++i )
+        {
+            const particle_sim& particle = particles[i];
+            localLower.x = std::min( localLower.x, particle.x );
+            localLower.y = std::min( localLower.y, particle.y );
+            localLower.z = std::min( localLower.z, particle.z );
+            localUpper.x = std::max( localUpper.x, particle.x );
+            localUpper.y = std::max( localUpper.y, particle.y );
+            localUpper.z = std::max( localUpper.z, particle.z );
+            localColorLower = std::min( localColorLower, particle.e.r );
+            localColorUpper = std::max( localColorUpper, particle.e.r );
+        }
+#pragma omp critical
+        {
+            lower.x = std::min( lower.x, localLower.x );
+            lower.y = std::min( lower.y, localLower.y );
+            lower.z = std::min( lower.z, localLower.z );
+            upper.x = std::max( upper.x, localUpper.x );
+            upper.y = std::max( upper.y, localUpper.y );
+            upper.z = std::max( upper.z, localUpper.z );
+            colorLower = std::min( colorLower, localColorLower );
+            colorUpper = std::max( colorUpper, localColorUpper );
+        }
+    }
+
+    const vec3 scale( _getScale( lower.x, upper.x, _maxPosition ),
+                      _getScale( lower.y, upper.y, _maxPosition ),
+                      _getScale( lower.z, upper.z, _maxPosition ));
+    const float colorScale = _getScale( colorLower, colorUpper, _maxColor );
+
+    auto positions = std::make_shared< std::vector< Position > >(
+                         particles.size( ));
+    auto radii = std::make_shared< std::vector< uint16_t > >(
+                     particles.size( ));
+    auto intensities = std::make_shared< std::vector< uint16_t > >(
+                           particles.size( ));
+    auto types = std::make_shared< std::vector< uint8_t > >(
+                     particles.size( ));
+    auto colors = std::make_shared< std::vector< uint8_t > >(
+                      particles.size( ));
+
+#pragma omp parallel for schedule( static )
+    for( int64_t i = 0; i < numParticles; ++i )
+    {
+        const particle_sim& particle = particles[i];
+        Position& position = ( *positions )[i];
+        position.x = _quantize( particle.x, lower.x, scale.x, _maxPosition );
+        position.y = _quantize( particle.y, lower.y, scale.y, _maxPosition );
+        position.z = _quantize( particle.z, lower.z, scale.z, _maxPosition );
+        ( *radii )[i] = _toHalf( particle.r );
+        ( *intensities )[i] = _toHalf( particle.I );
+        ( *types )[i] = uint8_t( particle.type );
+        ( *colors )[i] = uint8_t( _quantize( particle.e.r, colorLower,
+                                             colorScale, _maxColor ));
+    }
+
+    // quantized columns are only comparable with the same quantization
+    const bool samePositions = lower.x == _origin.x && lower.y == _origin.y &&
+                               lower.z == _origin.z && scale.x == _scale.x &&
+                               scale.y == _scale.y && scale.z == _scale.z;
+    const bool sameColors = colorLower == _colorOrigin &&
+                            colorScale == _colorScale;
+
+    _positions = _share( positions, samePositions ? _positions : nullptr );
+    _radii = _share( radii, _radii );
+    _intensities = _share( intensities, _intensities );
+    _types = _share( types, _types );
+    _colors = _share( colors, sameColors ? _colors : nullptr );
+    _origin = lower;
+    _scale = scale;
+    _colorOrigin = colorLower;
+    _colorScale = colorScale;
+}
+
+void CompactFrame::decode( Particles& particles ) const
+{
+    FramePool::allocate( particles, size( ));
+    if( particles.empty( ))
+        return;
+
+    const Position* positions = _positions->data();
+    const uint16_t* radii = _radii->data();
+    const uint16_t* intensities = _intensities->data();
+    const uint8_t* types = _types->data();
+    const uint8_t* colors = _colors->data();
+
+    const int64_t numParticles = particles.size();
+#pragma omp parallel for schedule( static )
+    for( int64_t i = 0; i < numParticles; ++i )
+    {
+        particle_sim& particle = particles[i];
+        particle.x = _origin.x + float( positions[i].x ) * _scale.x;
+        particle.y = _origin.y + float( positions[i].y ) * _scale.y;
+        particle.z = _origin.z + float( positions[i].z ) * _scale.z;
+        particle.r = _fromHalf( radii[i] );
+        particle.I = _fromHalf( intensities[i] );
+        particle.e = COLOUR( _colorOrigin + float( colors[i] ) * _colorScale,
+                             0.f, 0.f );
+        particle.type = types[i];
+        particle.active = true;
+    }
+}
+
+void CompactFrame::decode( const CompactFrame& next, const float blend,
+                           const bool attributes, Particles& particles ) const
+{
+    FramePool::allocate( particles, size( ));
+    if( particles.empty( ))
+        return;
+
+    // the attributes of this frame are kept with a zero weight
+    const float attributeBlend = attributes ? blend : 0.f;
+    const Position* positions = _positions->data();
+    const Position* nextPositions = next._positions->data();
+    const uint16_t* radii = _radii->data();
+    const uint16_t* nextRadii = next._radii->data();
+    const uint16_t* intensities = _intensities->data();
+    const uint16_t* nextIntensities = next._intensities->data();
+    const uint8_t* types = _types->data();
+    const uint8_t* colors = _colors->data();
+    const uint8_t* nextColors = next._colors->data();
+
+    const int64_t numParticles = particles.size();
+#pragma omp parallel for schedule( static )
+    for( int64_t i = 0; i < numParticles; ++i )
+    {
+        const vec3 a( _origin.x + float( positions[i].x ) * _scale.x,
+                      _origin.y + float( positions[i].y ) * _scale.y,
+                      _origin.z + float( positions[i].z ) * _scale.z );
+        const vec3 b(
+            next._origin.x + float( nextPositions[i].x ) * next._scale.x,
+            next._origin.y + float( nextPositions[i].y ) * next._scale.y,
+            next._origin.z + float( nextPositions[i].z ) * next._scale.z );
+        const float radius = _fromHalf( radii[i] );
+        const float intensity = _fromHalf( intensities[i] );
+        const float color = _colorOrigin + float( colors[i] ) * _colorScale;
+        const float nextColor = next._colorOrigin +
+                                float( nextColors[i] ) * next._colorScale;
+
+        particle_sim& particle = particles[i];
+        particle.x = a.x + ( b.x - a.x ) * blend;
+        particle.y = a.y + ( b.y - a.y ) * blend;
+        particle.z = a.z + ( b.z - a.z ) * blend;
+        particle.r = radius + ( _fromHalf( nextRadii[i] ) - radius ) *
+                              attributeBlend;
+        particle.I = intensity + ( _fromHalf( nextIntensities[i] ) -
+                                   intensity ) * attributeBlend;
+        particle.e = COLOUR( color + ( nextColor - color ) * attributeBlend,
+                             0.f, 0.f );
+        particle.type = types[i];
+        particle.active = true;
+    }
+}
+
+size_t CompactFrame::size() const
+{
+    return _positions ? _positions->size() : 0;
+}
+
+void CompactFrame::clear()
+{
+    *this = CompactFrame();
+}
+
+}
@@ -0,0 +1,107 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_COMPACTFRAME_H
+#define SEQ_SPLOTCH_COMPACTFRAME_H
+
+#include "framePool.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace seqSplotch
+{
+
+/**
+ * A cached frame in a third of the memory of its particle_sim structs.
+ *
+ * Positions are 16-bit fixed point relative to the bounds of the frame,
+ * radius and intensity half floats, the type and the colour value 8 bit.
+ * Only scalar colours are kept, the green and blue channels of vector
+ * colours are lost. The order of the particles is unchanged, so the levels
+ * of the boost pyramid stay prefixes.
+ *
+ * The attributes are stored in immutable columns. A column which did not
+ * change since the previous content is shared with the copies of the frame
+ * made before, so a time series of the same particle set mostly grows with
+ * the positions.
+ */
+class CompactFrame
+{
+public:
+    typedef FramePool::Particles Particles;
+
+    CompactFrame();
+
+    /** @return the bytes per particle of a compact frame. */
+    static size_t getParticleSize();
+
+    /**
+     * Replace the content with the quantized particles. Columns equal to the
+     * current ones are kept, so encode a copy of the previous frame.
+     */
+    void encode( const Particles& particles );
+
+    /** Decode all particles into the given buffer, in parallel. */
+    void decode( Particles& particles ) const;
+
+    /**
+     * Decode all particles blended towards the ones of next, a frame of the
+     * same size, like interpolateParticles() does with decoded frames.
+     */
+    void decode( const CompactFrame& next, float blend, bool attributes,
+                 Particles& particles ) const;
+
+    size_t size() const;
+    void clear();
+
+private:
+    struct Position
+    {
+        Position() {} // not initialized, filled in parallel
+
+        uint16_t x, y, z;
+    };
+
+    template< class T >
+    using Column = std::shared_ptr< const std::vector< T > >;
+
+    Column< Position > _positions;
+    Column< uint16_t > _radii; // half floats
+    Column< uint16_t > _intensities; // half floats
+    Column< uint8_t > _types;
+    Column< uint8_t > _colors;
+    vec3 _origin;
+    vec3 _scale; // of the positions
+    float _colorOrigin;
+    float _colorScale;
+};
+
+}
+
+#endif
@@ -0,0 +1,189 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "configWriter.h"
+
+#include "kernels.h"
+#include "model.h"
+
+#include <fstream>
+
+namespace seqSplotch
+{
+namespace
+{
+void _writeNode( std::ostream& os, const bool isAppNode, const size_t index,
+                 const int width, const int height )
+{
+    os << "        " << ( isAppNode ? "appNode" : "node" ) << std::endl
+       << "        {" << std::endl
+       << "            connection { hostname \"127.0.0.1\" }" << std::endl;
+    if( !isAppNode ) // start the render client locally instead of over ssh
+        os << "            attributes { launch_command \"%c\" }" << std::endl;
+    os << "            pipe" << std::endl
+       << "            {" << std::endl
+       << "                window" << std::endl
+       << "                {" << std::endl
+       << "                    viewport [ 0 0 " << width << " " << height
+       << " ]" << std::endl
+       << "                    attributes { hint_drawable FBO }" << std::endl
+       << "                    channel { name \"channel" << index << "\" }"
+       << std::endl
+       << "                }" << std::endl
+       << "            }" << std::endl
+       << "        }" << std::endl;
+}
+}
+
+ConfigWriter::ConfigWriter( const size_t numClients,
+                            const Decomposition decomposition,
+                            const int width, const int height )
+    : _numClients( numClients )
+    , _decomposition( decomposition )
+    , _width( width )
+    , _height( height )
+    , _balance( false )
+{
+    // even split: equal DB ranges hold equal particle counts
+    const size_t numStripes = _getNumStripes();
+    for( size_t i = 0; i < numStripes; ++i )
+        _split.push_back( float( i ) / float( numStripes ));
+    _split.push_back( 1.f );
+}
+
+void ConfigWriter::seed( Model& model )
+{
+    if( _decomposition == DECOMPOSITION_DB )
+        return;
+
+    // both eyes see nearly the same particles, they share the split
+    const float fov = model.getParams().find< float >( "fov", 45.f );
+    _split = computeTileSplit( model.getParticles(), model.getModelMatrix(),
+                               fov, float( _width ) / float( _height ),
+                               _getNumStripes( ));
+}
+
+void ConfigWriter::setBalance( const bool balance )
+{
+    _balance = balance;
+}
+
+bool ConfigWriter::write( const std::string& filename ) const
+{
+    const size_t numParts = _numClients + 1;
+    const bool isStereo = _decomposition == DECOMPOSITION_STEREO;
+    if( isStereo && numParts > 1 && numParts % 2 != 0 )
+    {
+        LBERROR << "Stereo needs an even number of nodes, not " << numParts
+                << std::endl;
+        return false;
+    }
+
+    std::ofstream file( filename.c_str( ));
+    if( !file )
+    {
+        LBERROR << "Can't write Equalizer config " << filename << std::endl;
+        return false;
+    }
+
+    file << "#Equalizer 1.2 ascii" << std::endl
+         << "server" << std::endl
+         << "{" << std::endl
+         << "    connection { hostname \"127.0.0.1\" }" << std::endl
+         << "    config" << std::endl
+         << "    {" << std::endl
+         << "        latency 0" << std::endl;
+    for( size_t i = 0; i <= _numClients; ++i )
+        _writeNode( file, i == 0, i, _width, _height );
+    file << "        observer {}" << std::endl
+         << "        layout { view { observer 0"
+         << ( isStereo ? " mode STEREO" : "" ) << " }}" << std::endl
+         << "        canvas" << std::endl
+         << "        {" << std::endl
+         << "            layout 0" << std::endl
+         << "            wall {}" << std::endl
+         << "            segment { channel \"channel0\" }" << std::endl
+         << "        }" << std::endl
+         << "        compound" << std::endl
+         << "        {" << std::endl
+         << "            channel ( segment 0 view 0 )" << std::endl;
+
+    const bool isDB = _decomposition == DECOMPOSITION_DB;
+    if( isDB )
+        file << "            buffer [ COLOR DEPTH ]" << std::endl;
+    if( isStereo )
+        file << "            eye [ LEFT RIGHT ]" << std::endl;
+    else if( _balance )
+        file << "            load_equalizer { mode " << ( isDB ? "DB" : "2D" )
+             << " }" << std::endl;
+
+    const size_t numStripes = _getNumStripes();
+    for( size_t i = 0; i < numParts; ++i )
+    {
+        const size_t stripe = i % numStripes;
+        const float start = _split[stripe];
+        const float end = _split[stripe + 1];
+        file << "            compound" << std::endl
+             << "            {" << std::endl;
+        if( i > 0 )
+            file << "                channel \"channel" << i << "\""
+                 << std::endl;
+        if( isStereo && numParts > 1 )
+            file << "                eye [ " << ( i < numStripes ? "LEFT"
+                                                                 : "RIGHT" )
+                 << " ]" << std::endl;
+        if( isDB )
+            file << "                range [ " << start << " " << end << " ]"
+                 << std::endl;
+        else
+            file << "                viewport [ " << start << " 0 "
+                 << end - start << " 1 ]" << std::endl;
+        if( i > 0 )
+            file << "                outputframe { name \"frame.channel" << i
+                 << "\" }" << std::endl;
+        file << "            }" << std::endl;
+    }
+    for( size_t i = 1; i <= _numClients; ++i )
+        file << "            inputframe { name \"frame.channel" << i << "\" }"
+             << std::endl;
+
+    file << "        }" << std::endl
+         << "    }" << std::endl
+         << "}" << std::endl;
+    return file.good();
+}
+
+size_t ConfigWriter::_getNumStripes() const
+{
+    const size_t numParts = _numClients + 1;
+    if( _decomposition == DECOMPOSITION_STEREO && numParts > 1 )
+        return numParts / 2;
+    return numParts;
+}
+
+}
@@ -0,0 +1,93 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_CONFIGWRITER_H
+#define SEQ_SPLOTCH_CONFIGWRITER_H
+
+#include "types.h"
+
+#include <string>
+#include <vector>
+
+namespace seqSplotch
+{
+
+/**
+ * Writes Equalizer configurations for an application node and a number of
+ * render clients on the local machine, which share the view in a sort-first
+ * (2D), sort-last (DB) or stereo decomposition. Stereo renders each eye on
+ * half of the nodes, split in 2D.
+ *
+ * The initial split follows a particle count cost model: 2D stripes show
+ * the same number of particles, DB ranges hold the same number of particles.
+ * DB is for the GPU and OSPRay renderers: the Splotch images are tone-mapped
+ * per range and have no depth, so they can't be composited sort-last.
+ */
+class ConfigWriter
+{
+public:
+    enum Decomposition
+    {
+        DECOMPOSITION_2D,
+        DECOMPOSITION_DB,
+        DECOMPOSITION_STEREO
+    };
+
+    /** @param numClients the render clients besides the application node */
+    ConfigWriter( size_t numClients, Decomposition decomposition,
+                  int width, int height );
+
+    /** Seed the 2D split with the particles visible from the model camera. */
+    void seed( Model& model );
+
+    /**
+     * Refine the 2D and DB split with Equalizer's load equalizer from the
+     * measured draw times, which starts from an even split.
+     */
+    void setBalance( bool balance );
+
+    /**
+     * @return false if the file could not be written, or if stereo has an odd
+     *         number of nodes.
+     */
+    bool write( const std::string& filename ) const;
+
+private:
+    size_t _getNumStripes() const;
+
+    const size_t _numClients;
+    const Decomposition _decomposition;
+    const int _width;
+    const int _height;
+    bool _balance;
+    std::vector< float > _split;
+};
+
+}
+
+#endif
@@ -0,0 +1,160 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cores.h"
+
+#include <lunchbox/log.h>
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#  include <pthread.h>
+#  include <sched.h>
+#  include <unistd.h>
+#endif
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+
+namespace seqSplotch
+{
+namespace
+{
+std::mutex _sharesMutex;
+std::vector< const void* > _shares;
+
+// the cores of the calling thread, or of the process if thread is false
+std::vector< int > _getCores( const bool thread )
+{
+    std::vector< int > cores;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO( &set );
+    // the affinity of the main thread is the one of the process
+    const int result = thread ?
+        ::pthread_getaffinity_np( ::pthread_self(), sizeof( set ), &set ) :
+        ::sched_getaffinity( ::getpid(), sizeof( set ), &set );
+    if( result == 0 )
+    {
+        for( int cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+            if( CPU_ISSET( cpu, &set ))
+                cores.push_back( cpu );
+    }
+#endif
+    const unsigned numCores = std::thread::hardware_concurrency();
+    if( cores.empty( ))
+        for( unsigned cpu = 0; cpu < numCores; ++cpu )
+            cores.push_back( int( cpu ));
+    return cores;
+}
+}
+
+void addCoreShare( const void* owner )
+{
+    std::lock_guard< std::mutex > lock( _sharesMutex );
+    _shares.push_back( owner );
+}
+
+void removeCoreShare( const void* owner )
+{
+    std::lock_guard< std::mutex > lock( _sharesMutex );
+    _shares.erase( std::remove( _shares.begin(), _shares.end(), owner ),
+                   _shares.end( ));
+}
+
+size_t partitionCores( const void* owner, const size_t numThreads,
+                       const bool pin )
+{
+    const std::vector< int > threadCores = _getCores( true );
+    const std::vector< int > cores = _getCores( false );
+    if( cores.empty( ))
+        return std::max( numThreads, size_t( 1 ));
+
+    // placed by Equalizer already, use all of it
+    if( threadCores.size() < cores.size( ))
+    {
+        const size_t threads = numThreads > 0 ? numThreads
+                                              : threadCores.size();
+#ifdef _OPENMP
+        ::omp_set_num_threads( int( threads ));
+#endif
+        LBINFO << "Thread uses " << threads << " OpenMP threads on its "
+               << threadCores.size() << " cores" << std::endl;
+        return threads;
+    }
+
+    size_t index = 0;
+    size_t numShares = 1;
+    {
+        std::lock_guard< std::mutex > lock( _sharesMutex );
+        const auto i = std::find( _shares.begin(), _shares.end(), owner );
+        index = i == _shares.end() ? 0 : size_t( i - _shares.begin( ));
+        numShares = _shares.size();
+    }
+
+    // contiguous slices keep the threads of a share on neighbouring cores;
+    // with more shares than cores, shares overlap on single cores
+    const size_t shares = std::max( numShares, size_t( 1 ));
+    const size_t share = index % shares;
+    size_t begin = share * cores.size() / shares;
+    size_t end = ( share + 1 ) * cores.size() / shares;
+    if( begin == end )
+    {
+        begin = share % cores.size();
+        end = begin + 1;
+    }
+
+    const size_t threads = numThreads > 0 ? numThreads : end - begin;
+#ifdef __linux__
+    if( pin )
+    {
+        cpu_set_t set;
+        CPU_ZERO( &set );
+        for( size_t i = begin; i < end; ++i )
+            CPU_SET( cores[i], &set );
+        if( ::pthread_setaffinity_np( ::pthread_self(), sizeof( set ),
+                                      &set ) != 0 )
+        {
+            LBWARN << "Can't pin thread to cores " << cores[begin] << ".."
+                   << cores[end - 1] << std::endl;
+        }
+    }
+#endif
+#ifdef _OPENMP
+    ::omp_set_num_threads( int( threads ));
+#endif
+    LBINFO << "Thread " << share << " of " << shares << " uses " << threads
+           << " OpenMP threads on cores " << cores[begin] << ".."
+           << cores[end - 1] << ( pin ? ", pinned" : "" ) << std::endl;
+    return threads;
+}
+
+}
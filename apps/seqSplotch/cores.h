@@ -0,0 +1,64 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_CORES_H
+#define SEQ_SPLOTCH_CORES_H
+
+#include <cstddef>
+
+namespace seqSplotch
+{
+
+/**
+ * Add a thread to the threads sharing the cores of the process, identified
+ * by its owner. Shares are ordered by the time they were added.
+ */
+void addCoreShare( const void* owner );
+
+/** Remove a thread added with addCoreShare(). */
+void removeCoreShare( const void* owner );
+
+/**
+ * Restrict the OpenMP threads of the calling thread to its share of the
+ * cores of the process, so the pipe threads of a node do not oversubscribe
+ * them with one full team each. The cores of the process honour taskset.
+ *
+ * A thread which is already restricted to a subset of the cores of the
+ * process, like by Equalizer's hint_affinity, uses all cores of its mask.
+ *
+ * @param owner the owner of the share of the calling thread
+ * @param numThreads the OpenMP threads to use, 0 for the cores of the share
+ * @param pin bind the calling thread and the OpenMP threads it starts to the
+ *            cores of its share
+ * @return the number of OpenMP threads of the calling thread
+ */
+size_t partitionCores( const void* owner, size_t numThreads, bool pin );
+
+}
+
+#endif
@@ -0,0 +1,126 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "framePool.h"
+
+#include <sys/mman.h>
+
+namespace
+{
+const uintptr_t _hugePageSize = 2 << 20;
+}
+
+namespace seqSplotch
+{
+
+FramePool::FramePool( const size_t maxFree )
+    : _maxFree( maxFree )
+    , _frameSize( 0 )
+{
+}
+
+void FramePool::setFrameSize( const size_t size )
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    _frameSize = size;
+}
+
+FramePool::Particles FramePool::acquire()
+{
+    Particles particles;
+    size_t frameSize = 0;
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+        frameSize = _frameSize;
+        if( !_free.empty( ))
+        {
+            particles = std::move( _free.back( ));
+            _free.pop_back();
+        }
+    }
+
+    particles.clear();
+    reserve( particles, frameSize );
+    return particles;
+}
+
+FramePool::Particles FramePool::acquire( const size_t size )
+{
+    Particles particles = acquire();
+    allocate( particles, size );
+    return particles;
+}
+
+void FramePool::allocate( Particles& particles, const size_t size )
+{
+    // reused pages stay where they were touched first
+    if( particles.capacity() < size )
+        reserve( particles, size );
+    particles.resize( size );
+}
+
+void FramePool::reserve( Particles& particles, const size_t capacity )
+{
+    if( particles.capacity() >= capacity )
+        return;
+
+    // particle_sim does not initialize, resize() does not touch the pages
+    Particles().swap( particles );
+    particles.reserve( capacity );
+    particles.resize( capacity );
+
+#ifdef MADV_HUGEPAGE
+    // Before the first touch, so the page faults map 2 MB pages right away.
+    // Only the aligned interior of the buffer qualifies.
+    const uintptr_t begin = reinterpret_cast< uintptr_t >( particles.data( ));
+    const uintptr_t end = begin + capacity * sizeof( particle_sim );
+    const uintptr_t first = ( begin + _hugePageSize - 1 ) &
+                            ~( _hugePageSize - 1 );
+    const uintptr_t last = end & ~( _hugePageSize - 1 );
+    if( last > first )
+        ::madvise( reinterpret_cast< void* >( first ), last - first,
+                   MADV_HUGEPAGE );
+#endif
+
+    const int64_t numParticles = capacity;
+#pragma omp parallel for schedule( static )
+    for( int64_t i = 0; i < numParticles; ++i )
+        particles[i].active = false;
+    particles.clear();
+}
+
+void FramePool::release( Particles&& particles )
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    if( _free.size() < _maxFree && particles.capacity() > 0 )
+        _free.emplace_back( std::move( particles ));
+    else
+        Particles().swap( particles );
+}
+
+}
@@ -0,0 +1,93 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_FRAMEPOOL_H
+#define SEQ_SPLOTCH_FRAMEPOOL_H
+
+#include <splotch/splotchutils.h>
+
+#include <mutex>
+
+namespace seqSplotch
+{
+
+/**
+ * Recycles the particle buffers of dropped frames, so streaming through a
+ * time series does not reallocate once the buffers reached the frame size.
+ * Buffers are backed by transparent huge pages where the kernel supports
+ * them. Thread-safe, frames may be prefetched in the background.
+ */
+class FramePool
+{
+public:
+    typedef std::vector< particle_sim > Particles;
+
+    /** @param maxFree the number of unused buffers kept */
+    explicit FramePool( size_t maxFree = 2 );
+
+    /**
+     * Reserve all buffers acquired from now on for frames of the given size,
+     * so loading a frame does not grow its buffer.
+     */
+    void setFrameSize( size_t size );
+
+    /**
+     * @return an empty buffer, with the capacity of a released one and at
+     *         least the frame size.
+     */
+    Particles acquire();
+
+    /** @return a buffer of the given size, see allocate(). */
+    Particles acquire( size_t size );
+
+    /**
+     * Resize particles to size. New storage is first touched by all OpenMP
+     * threads in static chunks, so each page lands on the NUMA node of the
+     * thread which projects and splats it later.
+     */
+    static void allocate( Particles& particles, size_t size );
+
+    /**
+     * Reserve capacity for particles in huge pages, first touched like in
+     * allocate(). The content of particles is lost if it has to grow.
+     */
+    static void reserve( Particles& particles, size_t capacity );
+
+    /** Return a buffer to the pool, freed if the pool is full. */
+    void release( Particles&& particles );
+
+private:
+    const size_t _maxFree;
+    size_t _frameSize;
+    std::mutex _mutex;
+    std::vector< Particles > _free;
+};
+
+}
+
+#endif
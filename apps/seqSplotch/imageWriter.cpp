@@ -0,0 +1,124 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "imageWriter.h"
+
+#include <lunchbox/log.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace seqSplotch
+{
+
+ImageWriter::ImageWriter( const size_t numThreads )
+    : _maxQueued( 2 * std::max( numThreads, size_t( 1 )))
+    , _numBusy( 0 )
+    , _running( true )
+{
+    for( size_t i = 0; i < std::max( numThreads, size_t( 1 )); ++i )
+        _threads.emplace_back( [this] { _run(); });
+}
+
+ImageWriter::~ImageWriter()
+{
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+        _running = false;
+    }
+    _condition.notify_all();
+    for( std::thread& thread : _threads )
+        thread.join();
+}
+
+void ImageWriter::write( const std::string& filename,
+                         std::vector< float >& pixels, const int width,
+                         const int height )
+{
+    std::unique_lock< std::mutex > lock( _mutex );
+    _condition.wait( lock, [this] { return _queue.size() < _maxQueued; });
+    _queue.push_back( Image{ filename, std::vector< float >( ), width,
+                             height });
+    _queue.back().pixels.swap( pixels );
+    lock.unlock();
+    _condition.notify_all();
+}
+
+void ImageWriter::flush()
+{
+    std::unique_lock< std::mutex > lock( _mutex );
+    _condition.wait( lock, [this] { return _queue.empty() && _numBusy == 0; });
+}
+
+void ImageWriter::_run()
+{
+    for( ;; )
+    {
+        std::unique_lock< std::mutex > lock( _mutex );
+        _condition.wait( lock, [this] { return !_queue.empty() || !_running; });
+        if( _queue.empty( ))
+            return;
+
+        const Image image = std::move( _queue.front( ));
+        _queue.pop_front();
+        ++_numBusy;
+        lock.unlock();
+        _condition.notify_all();
+
+        _write( image );
+
+        lock.lock();
+        --_numBusy;
+        lock.unlock();
+        _condition.notify_all();
+    }
+}
+
+void ImageWriter::_write( const Image& image )
+{
+    std::vector< unsigned char > bytes( image.pixels.size( ));
+    const size_t rowSize = size_t( image.width ) * 3;
+    for( int y = 0; y < image.height; ++y )
+    {
+        // PPM rows are top-down
+        const float* src = &image.pixels[( image.height - 1 - y ) * rowSize];
+        unsigned char* dst = &bytes[y * rowSize];
+        for( size_t i = 0; i < rowSize; ++i )
+            dst[i] = (unsigned char)( std::max( 0.f, std::min( src[i], 1.f )) *
+                                      255.f + .5f );
+    }
+
+    std::ofstream file( image.filename.c_str(), std::ios::binary );
+    file << "P6\n" << image.width << " " << image.height << "\n255\n";
+    file.write( reinterpret_cast< const char* >( bytes.data( )),
+                bytes.size( ));
+    if( !file )
+        LBWARN << "Can't write " << image.filename << std::endl;
+}
+
+}
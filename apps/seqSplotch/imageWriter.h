@@ -0,0 +1,91 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_IMAGEWRITER_H
+#define SEQ_SPLOTCH_IMAGEWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace seqSplotch
+{
+
+/**
+ * Thread pool encoding RGB float images to binary PPM files.
+ *
+ * write() blocks while the queue is full, which bounds the memory held by
+ * images waiting for slow storage.
+ */
+class ImageWriter
+{
+public:
+    /** @param numThreads the number of encoder threads, at least one */
+    explicit ImageWriter( size_t numThreads );
+
+    /** Finish all queued images. */
+    ~ImageWriter();
+
+    /**
+     * Queue a bottom-up, row-major RGB image for writing.
+     *
+     * @param pixels the image, moved from
+     */
+    void write( const std::string& filename, std::vector< float >& pixels,
+                int width, int height );
+
+    /** Wait until all queued images are written. */
+    void flush();
+
+private:
+    struct Image
+    {
+        std::string filename;
+        std::vector< float > pixels;
+        int width;
+        int height;
+    };
+
+    void _run();
+    static void _write( const Image& image );
+
+    const size_t _maxQueued;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque< Image > _queue;
+    size_t _numBusy;
+    bool _running;
+    std::vector< std::thread > _threads;
+};
+
+}
+
+#endif
@@ -0,0 +1,535 @@
+
+/* Copyright (c) 2011-2015, Stefan Eilemann <eile@eyescale.ch>
+ *               2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "kernels.h"
+
+#include "tracer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+namespace seqSplotch
+{
+
+void colorizeParticles( Model& model, Model::Particles& filtered,
+                        std::vector< size_t >& numLevelParticles,
+                        const uint32_t hiddenTypes )
+{
+    const auto& allParticles = model.getParticles();
+
+    filtered.clear();
+    filtered.reserve( allParticles.size( ));
+
+    // Levels are prefixes of the particles, remember where each one ends
+    numLevelParticles.assign( model.getNumLevels(), 0 );
+    size_t level = model.getNumLevels() - 1;
+
+    // Generate colour in same way splotch does (Add brightness here):
+    for( const auto& range : model.getVisibleRanges( hiddenTypes ))
+    {
+        for( size_t i = range.first; i < range.second; ++i )
+        {
+            // hidden ranges may contain the first particle of a level
+            while( level > 0 && i >= model.getNumParticles( level ))
+                numLevelParticles[level--] = filtered.size();
+
+            const auto& particle = allParticles[i];
+            if( particle.r <= std::numeric_limits< float >::epsilon( ))
+                continue;
+
+            filtered.push_back( particle );
+            auto& newParticle = *filtered.rbegin();
+            if (!model.getColourIsVec()[particle.type])
+                newParticle.e = model.getColorMaps()[particle.type].getVal_const(particle.e.r) * particle.I;
+            else
+                newParticle.e *= particle.I;
+        }
+    }
+
+    for( size_t i = 0; i <= level; ++i )
+        numLevelParticles[i] = filtered.size();
+}
+
+void colorParticles( paramfile& params, Model::Particles& particles,
+                     const std::vector< COLOURMAP >& colorMaps,
+                     const float brightness )
+{
+    if( colorMaps.empty( ))
+        return;
+
+    const size_t numTypes = colorMaps.size();
+    std::vector< float > typeBrightness( numTypes );
+    std::vector< char > isVector( numTypes );
+    for( size_t i = 0; i < numTypes; ++i )
+    {
+        typeBrightness[i] = brightness * params.find< float >(
+                                "brightness" + dataToString( i ), 1.f );
+        isVector[i] = params.find< bool >(
+                          "color_is_vector" + dataToString( i ), false );
+    }
+
+    const int64_t numParticles = particles.size();
+#pragma omp parallel for schedule( static )
+    for( int64_t i = 0; i < numParticles; ++i )
+    {
+        particle_sim& particle = particles[i];
+        const size_t type = std::min< size_t >( particle.type, numTypes - 1 );
+        if( isVector[type] )
+            particle.e = particle.e * particle.I;
+        else
+            particle.e = colorMaps[type].getVal_const( particle.e.r ) *
+                         particle.I;
+        particle.e = particle.e * typeBrightness[type];
+    }
+}
+
+void fillParticleBuffers( const Model::Particles& particles,
+                          seq::Vector4f* positions, seq::Vector4f* colors )
+{
+    for( size_t i = 0; i < particles.size(); ++i )
+    {
+        positions[i] = seq::Vector4f( particles[i].x, particles[i].y, particles[i].z, 1.0f );
+        colors[i] = seq::Vector4f( particles[i].e.r, particles[i].e.g, particles[i].e.b, 1.0f );
+    }
+}
+
+void fillQuadIndices( const size_t numParticles,
+                      std::vector< uint32_t >& indices )
+{
+    indices.resize( numParticles * 6 );
+    for (size_t i = 0, j = 0; i < numParticles; ++i)
+    {
+        size_t index = i << 2;
+        indices[j++] = index;
+        indices[j++] = index + 1;
+        indices[j++] = index + 2;
+        indices[j++] = index;
+        indices[j++] = index + 2;
+        indices[j++] = index + 3;
+    }
+}
+
+void toneMap( arr2< COLOUR >& pic, paramfile& params )
+{
+    const int width = pic.size1();
+    const int height = pic.size2();
+
+    const bool a_eq_e = params.find<bool>("a_eq_e",true);
+    if( a_eq_e )
+    {
+        exptable<float32> xexp(-20.0);
+#pragma omp parallel for
+        for( int ix = 0; ix < width; ++ix )
+        {
+            for( int iy = 0; iy < height; ++iy )
+            {
+                pic[ix][iy].r = -xexp.expm1(pic[ix][iy].r);
+                pic[ix][iy].g = -xexp.expm1(pic[ix][iy].g);
+                pic[ix][iy].b = -xexp.expm1(pic[ix][iy].b);
+            }
+        }
+    }
+
+    const double gamma = params.find< double >("pic_gamma", 1.0 );
+    const double brightness = params.find< double >("pic_brighness", 0.0 );
+    const double contrast = params.find< double >("pic_contrast", 1.0 );
+
+    if( gamma != 1.0 || brightness != 0.0 || contrast != 1.0 )
+    {
+#pragma omp parallel for
+        for( tsize i = 0; i < pic.size1(); ++i )
+        {
+            for( tsize j = 0; j < pic.size2(); ++j )
+            {
+                pic[i][j].r = contrast * pow((double)pic[i][j].r,gamma) + brightness;
+                pic[i][j].g = contrast * pow((double)pic[i][j].g,gamma) + brightness;
+                pic[i][j].b = contrast * pow((double)pic[i][j].b,gamma) + brightness;
+            }
+       }
+    }
+}
+
+void transposeImage( const arr2< COLOUR >& pic, std::vector< float >& pixels )
+{
+    const int width = pic.size1();
+    const int height = pic.size2();
+
+    pixels.resize( width * height * 3 );
+    int k = 0;
+    for( int j = 0; j < height; ++j )
+    {
+        for( int i = 0; i < width; ++i, k+=3 )
+            memcpy( &pixels[k], &pic[i][j], 3 * sizeof( float ));
+    }
+}
+
+void copyParticles( const particle_sim* source, const size_t count,
+                    Model::Particles& target )
+{
+    FramePool::allocate( target, count );
+
+    const int64_t numParticles = count;
+#pragma omp parallel for schedule( static )
+    for( int64_t i = 0; i < numParticles; ++i )
+        target[i] = source[i];
+}
+
+void gatherParticles( const Model::Particles& particles,
+                      const Model::Ranges& ranges, Model::Particles& target )
+{
+    size_t size = 0;
+    for( const auto& range : ranges )
+        size += range.second - range.first;
+    FramePool::allocate( target, size );
+
+    size_t offset = 0;
+    for( const auto& range : ranges )
+    {
+        const particle_sim* source = particles.data() + range.first;
+        particle_sim* destination = target.data() + offset;
+        const int64_t count = range.second - range.first;
+#pragma omp parallel for schedule( static )
+        for( int64_t i = 0; i < count; ++i )
+            destination[i] = source[i];
+        offset += count;
+    }
+}
+
+void interpolateParticles( const Model::Particles& from,
+                           const Model::Particles& to, const float blend,
+                           const bool attributes, Model::Particles& target )
+{
+    FramePool::allocate( target, from.size( ));
+
+    // branch free, the attributes of from are kept with a zero weight
+    const float attributeBlend = attributes ? blend : 0.f;
+    const int64_t numParticles = from.size();
+    const particle_sim* source = from.data();
+    const particle_sim* destination = to.data();
+    particle_sim* result = target.data();
+#pragma omp parallel for simd schedule( static )
+    for( int64_t i = 0; i < numParticles; ++i )
+    {
+        const particle_sim& a = source[i];
+        const particle_sim& b = destination[i];
+        particle_sim& particle = result[i];
+        particle.x = a.x + ( b.x - a.x ) * blend;
+        particle.y = a.y + ( b.y - a.y ) * blend;
+        particle.z = a.z + ( b.z - a.z ) * blend;
+        particle.r = a.r + ( b.r - a.r ) * attributeBlend;
+        particle.I = a.I + ( b.I - a.I ) * attributeBlend;
+        particle.e.r = a.e.r + ( b.e.r - a.e.r ) * attributeBlend;
+        particle.e.g = a.e.g + ( b.e.g - a.e.g ) * attributeBlend;
+        particle.e.b = a.e.b + ( b.e.b - a.e.b ) * attributeBlend;
+        particle.type = a.type;
+        particle.active = a.active;
+    }
+}
+
+seq::Vector4f computeBoundingSphere( const Model::Particles& particles )
+{
+    if( particles.empty( ))
+        return seq::Vector4f( 0, 0, 0, 1 );
+
+    BoundingBox bbox;
+    bbox.Compute( particles );
+
+    const seq::Vector3f minExtend( bbox.minX, bbox.minY, bbox.minZ );
+    const seq::Vector3f maxExtend( bbox.maxX, bbox.maxY, bbox.maxZ );
+
+    seq::Vector4f boundingSphere;
+    boundingSphere.set_sub_vector< 3, 0 >( (minExtend + maxExtend) / 2.f );
+    boundingSphere.w() = minExtend.distance( maxExtend );
+    return boundingSphere;
+}
+
+std::vector< float > computeTileSplit( const Model::Particles& particles,
+                                       const seq::Matrix4f& modelView,
+                                       const float fov, const float aspect,
+                                       const size_t numTiles )
+{
+    // a histogram of the projected x coordinates of a subset is plenty for
+    // a starting point of the load balancer
+    const size_t numBins = 1024;
+    const size_t stride = std::max( particles.size() >> 20, size_t( 1 ));
+    const int64_t numSamples = ( particles.size() + stride - 1 ) / stride;
+    const float tanX = std::tan( fov * float( M_PI ) / 360.f );
+    const float tanY = tanX / aspect;
+
+    std::vector< size_t > histogram( numBins, 0 );
+#pragma omp parallel
+    {
+        std::vector< size_t > local( numBins, 0 );
+#pragma omp for
+        for( int64_t i = 0; i < numSamples; ++i )
+        {
+            const particle_sim& particle = particles[i * stride];
+            const seq::Vector4f pos = modelView *
+                     seq::Vector4f( particle.x, particle.y, particle.z, 1.f );
+            const float depth = -pos.z();
+            if( depth <= 0.f || std::abs( pos.x( )) > depth * tanX ||
+                std::abs( pos.y( )) > depth * tanY )
+            {
+                continue;
+            }
+            const float x = pos.x() / ( depth * tanX ) * .5f + .5f;
+            ++local[std::min( size_t( x * numBins ), numBins - 1 )];
+        }
+#pragma omp critical
+        for( size_t bin = 0; bin < numBins; ++bin )
+            histogram[bin] += local[bin];
+    }
+
+    size_t total = 0;
+    for( const size_t count : histogram )
+        total += count;
+
+    std::vector< float > split( numTiles + 1, 1.f );
+    split[0] = 0.f;
+    if( total == 0 ) // nothing visible, split evenly
+    {
+        for( size_t i = 1; i < numTiles; ++i )
+            split[i] = float( i ) / float( numTiles );
+        return split;
+    }
+
+    size_t sum = 0;
+    size_t tile = 1;
+    for( size_t bin = 0; bin < numBins && tile < numTiles; ++bin )
+    {
+        sum += histogram[bin];
+        while( tile < numTiles && sum * numTiles >= tile * total )
+            split[tile++] = float( bin + 1 ) / float( numBins );
+    }
+    return split;
+}
+
+#ifndef CUDA
+namespace
+{
+// The camera of Splotch's particle_project with a centre position: the axes
+// are the ones of the centre camera for all eyes, the eyes only move along
+// its x axis. Depth, radius and the order of a sort then do not depend on
+// the eye, x moves by the disparity scale / depth.
+struct Projection
+{
+    Projection( paramfile& params, const seq::Vector2i& size,
+                const seq::Vector2i& offset_ )
+        : width( float( size.x( )))
+        , height( float( size.y( )))
+        , offset( offset_ )
+    {
+        const float xres = float( params.find< int >( "xres", 800 ));
+        const float yres = float( params.find< int >( "yres", xres ));
+        const float fov = params.find< float >( "fov", 45.f );
+        scale = .5f * xres / std::tan( fov * float( M_PI ) / 360.f );
+        centerX = .5f * xres - float( offset.x( ));
+        centerY = .5f * yres - float( offset.y( ));
+        minRadius = params.find< float >( "minrad_pix", 1.f );
+        zMin = params.find< float >( "zmin", 0.f );
+        zMax = params.find< float >( "zmax", 1e23f );
+    }
+
+    // the particle is drawn if it is in depth range and overlaps the region
+    bool isVisible( const particle_sim& particle ) const
+    {
+        return particle.z > zMin && particle.z < zMax &&
+               particle.x + particle.r >= 0.f &&
+               particle.x - particle.r < width &&
+               particle.y + particle.r >= 0.f &&
+               particle.y - particle.r < height;
+    }
+
+    const float width;
+    const float height;
+    const seq::Vector2i offset;
+    float scale;
+    float centerX;
+    float centerY;
+    float minRadius;
+    float zMin;
+    float zMax;
+};
+
+void _project( const Projection& projection,
+               const Model::Particles& particles, const vec3& origin,
+               const vec3& lookAt, const vec3& up, const float eyeOffset,
+               Model::Particles& target )
+{
+    const seq::Vector3f center( origin.x, origin.y, origin.z );
+    seq::Vector3f zAxis = center - seq::Vector3f( lookAt.x, lookAt.y,
+                                                  lookAt.z );
+    zAxis /= zAxis.length();
+    seq::Vector3f xAxis = vmml::cross( seq::Vector3f( up.x, up.y, up.z ),
+                                       zAxis );
+    xAxis /= xAxis.length();
+    const seq::Vector3f yAxis = vmml::cross( zAxis, xAxis );
+    const seq::Vector3f eye = center + xAxis * eyeOffset;
+
+    FramePool::allocate( target, particles.size( ));
+    const int64_t numParticles = particles.size();
+#pragma omp parallel for schedule( static )
+    for( int64_t i = 0; i < numParticles; ++i )
+    {
+        particle_sim particle = particles[i];
+        const seq::Vector3f position = seq::Vector3f( particle.x, particle.y,
+                                                      particle.z ) - eye;
+        const float depth = -position.dot( zAxis );
+        const float factor = projection.scale /
+                             std::max( std::abs( depth ),
+                                   std::numeric_limits< float >::epsilon( ));
+        particle.x = position.dot( xAxis ) * factor + projection.centerX;
+        particle.y = position.dot( yAxis ) * factor + projection.centerY;
+        particle.z = depth;
+        particle.r *= factor;
+        particle.r = std::sqrt( particle.r * particle.r +
+                                projection.minRadius * projection.minRadius );
+        particle.active = projection.isVisible( particle );
+        target[i] = particle;
+    }
+}
+
+void _splat( paramfile& params, Model::Particles& particles,
+             arr2< COLOUR >& pic )
+{
+    pic.fill( COLOUR( 0, 0, 0 ));
+    if( particles.empty( ))
+        return;
+    render_new( particles.data(), particles.size(), pic,
+                params.find< bool >( "a_eq_e", true ),
+                params.find< float32 >( "gray_absorption", 0.2f ));
+}
+}
+
+void splatParticles( paramfile& params, const Model::Particles& particles,
+                     arr2< COLOUR >& pic, const vec3& origin,
+                     const vec3& lookAt, const vec3& up,
+                     const float eyeOffset, const seq::Vector2i& offset,
+                     Model::Particles& projected )
+{
+    const Projection projection( params, seq::Vector2i( pic.size1(),
+                                                         pic.size2( )),
+                                 offset );
+    _project( projection, particles, origin, lookAt, up, eyeOffset,
+              projected );
+
+    const int sortType = params.find< int >( "sort_type", 1 );
+    if( sortType != 0 && !projected.empty( ))
+        particle_sort( projected, sortType, false );
+    _splat( params, projected, pic );
+}
+
+void splatStereo( paramfile& params, const Model::Particles& particles,
+                  arr2< COLOUR >& left, arr2< COLOUR >& right,
+                  const vec3& origin, const vec3& lookAt, const vec3& up,
+                  const float eyeOffset, const seq::Vector2i& offset,
+                  Model::Particles& leftProjected,
+                  Model::Particles& rightProjected )
+{
+    // project and sort once for the left eye, then move the sorted
+    // particles by their disparity to the right eye
+    const Projection projection( params, seq::Vector2i( left.size1(),
+                                                        left.size2( )),
+                                 offset );
+    _project( projection, particles, origin, lookAt, up, -eyeOffset,
+              leftProjected );
+
+    const int sortType = params.find< int >( "sort_type", 1 );
+    if( sortType != 0 && !leftProjected.empty( ))
+        particle_sort( leftProjected, sortType, false );
+
+    FramePool::allocate( rightProjected, leftProjected.size( ));
+    const float disparity = 2.f * eyeOffset * projection.scale;
+    const int64_t numParticles = leftProjected.size();
+#pragma omp parallel for schedule( static )
+    for( int64_t i = 0; i < numParticles; ++i )
+    {
+        particle_sim particle = leftProjected[i];
+        particle.x -= disparity / std::max( std::abs( particle.z ),
+                                  std::numeric_limits< float >::epsilon( ));
+        particle.active = projection.isVisible( particle );
+        rightProjected[i] = particle;
+    }
+
+    _splat( params, leftProjected, left );
+    _splat( params, rightProjected, right );
+}
+
+size_t splatParticleFile( const ParticleFile& file, paramfile& params,
+                          arr2< COLOUR >& pic, const vec3& eye,
+                          const vec3& lookAt, const vec3& up,
+                          std::vector< COLOURMAP >& colorMaps )
+{
+    // Emission adds up, so batches can be splatted separately and summed
+    // before tone mapping. With absorption the result depends on the order.
+    if( !params.find< bool >( "a_eq_e", true ))
+        LBWARN << "Out-of-core rendering ignores absorption" << std::endl;
+
+    const size_t batchSize = std::max( params.find< int >( "ooc_batch",
+                                                           1 << 22 ), 1 );
+    Model::Particles batch;
+    Model::Particles nextBatch;
+    arr2< COLOUR > batchPic( pic.size1(), pic.size2( ));
+    pic.fill( COLOUR( 0, 0, 0 ));
+
+    // a read error ends the image with the batches splatted so far
+    size_t numSplatted = 0;
+    bool haveBatch = file.read( 0, batchSize, batch );
+    for( size_t offset = 0; haveBatch && offset < file.getNumParticles();
+         offset += batchSize )
+    {
+        // read the next batch while this one is splatted
+        std::future< bool > reading;
+        if( offset + batchSize < file.getNumParticles( ))
+            reading = std::async( std::launch::async, [&]
+            {
+                Tracer::Span span( "ParticleFile::read" );
+                return file.read( offset + batchSize, batchSize, nextBatch );
+            });
+
+        batchPic.fill( COLOUR( 0, 0, 0 ));
+        host_rendering( params, batch, batchPic, eye, eye, lookAt, up,
+                        colorMaps, 1.f, batch.size( ));
+
+#pragma omp parallel for
+        for( tsize i = 0; i < pic.size1(); ++i )
+            for( tsize j = 0; j < pic.size2(); ++j )
+                pic[i][j] += batchPic[i][j];
+
+        numSplatted += batch.size();
+        if( reading.valid( ))
+            haveBatch = reading.get();
+        batch.swap( nextBatch );
+    }
+    return numSplatted;
+}
+#endif
+
+}
@@ -0,0 +1,155 @@
+
+/* Copyright (c) 2011-2015, Stefan Eilemann <eile@eyescale.ch>
+ *               2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_KERNELS_H
+#define SEQ_SPLOTCH_KERNELS_H
+
+#include "model.h"
+
+namespace seqSplotch
+{
+
+/**
+ * The hot loops of the renderers, free of GL and OSPRay state so they can be
+ * benchmarked on their own by seqSplotchMicroBench.
+ */
+
+/**
+ * Drop particles without radius and of the hidden types, colour the
+ * remaining ones like Splotch does. The end of each boost level in filtered
+ * is written to numLevelParticles.
+ */
+void colorizeParticles( Model& model, Model::Particles& filtered,
+                        std::vector< size_t >& numLevelParticles,
+                        uint32_t hiddenTypes = 0 );
+
+/**
+ * Colour all particles like Splotch's particle_colorize, which only colours
+ * the particles a projection has activated. Done before the projection, the
+ * colours can be shared by all eyes.
+ */
+void colorParticles( paramfile& params, Model::Particles& particles,
+                     const std::vector< COLOURMAP >& colorMaps,
+                     float brightness );
+
+/** Write positions and colours of the particles to the mapped buffers. */
+void fillParticleBuffers( const Model::Particles& particles,
+                          seq::Vector4f* positions, seq::Vector4f* colors );
+
+/** Fill the two triangles per particle quad. */
+void fillQuadIndices( size_t numParticles, std::vector< uint32_t >& indices );
+
+/** Apply exposure, gamma, brightness and contrast to a Splotch image. */
+void toneMap( arr2< COLOUR >& pic, paramfile& params );
+
+/** Transpose the column-major Splotch image to row-major RGB pixels. */
+void transposeImage( const arr2< COLOUR >& pic, std::vector< float >& pixels );
+
+/**
+ * Copy count particles to target in static OpenMP chunks, the same split the
+ * Splotch projection uses, so each thread later reads what it wrote.
+ */
+void copyParticles( const particle_sim* source, size_t count,
+                    Model::Particles& target );
+
+/** Copy the ranges of particles to target, in parallel like copyParticles. */
+void gatherParticles( const Model::Particles& particles,
+                      const Model::Ranges& ranges, Model::Particles& target );
+
+/**
+ * Blend the positions of two frames of the same particles, in the order of
+ * the particles, into target. Radius, intensity and colour are blended too
+ * with attributes, otherwise they are the ones of from.
+ */
+void interpolateParticles( const Model::Particles& from,
+                           const Model::Particles& to, float blend,
+                           bool attributes, Model::Particles& target );
+
+/** @return the center and the diameter of the particles' bounding box. */
+seq::Vector4f computeBoundingSphere( const Model::Particles& particles );
+
+/**
+ * Particle count cost model for the initial sort-first split.
+ *
+ * @param modelView the camera of the view
+ * @param fov the horizontal field of view in degrees
+ * @param aspect the width of the view divided by its height
+ * @return the numTiles + 1 boundaries in [0, 1] of the vertical stripes
+ *         which show the same number of particles
+ */
+std::vector< float > computeTileSplit( const Model::Particles& particles,
+                                       const seq::Matrix4f& modelView,
+                                       float fov, float aspect,
+                                       size_t numTiles );
+
+#ifndef CUDA
+/**
+ * Project, cull, sort and splat colourised particles into pic with Splotch's
+ * render_new. The eye is eyeOffset to the right of the camera at origin,
+ * with the axes of that camera like Splotch's particle_project with a
+ * centre position. pic is the region at offset of the xres x yres image of
+ * params.
+ *
+ * @param projected receives the projected particles, inactive if culled
+ */
+void splatParticles( paramfile& params, const Model::Particles& particles,
+                     arr2< COLOUR >& pic, const vec3& origin,
+                     const vec3& lookAt, const vec3& up, float eyeOffset,
+                     const seq::Vector2i& offset,
+                     Model::Particles& projected );
+
+/**
+ * Splat the left and right eye, eyeOffset from origin, like two calls of
+ * splatParticles. Projection, culling and sorting run once: both eyes share
+ * depth, radius and order, the right eye only moves each particle of the
+ * left one by its disparity.
+ */
+void splatStereo( paramfile& params, const Model::Particles& particles,
+                  arr2< COLOUR >& left, arr2< COLOUR >& right,
+                  const vec3& origin, const vec3& lookAt, const vec3& up,
+                  float eyeOffset, const seq::Vector2i& offset,
+                  Model::Particles& leftProjected,
+                  Model::Particles& rightProjected );
+
+/**
+ * Splat all particles of the file into pic with host_rendering, in batches
+ * of the ooc_batch parameter. The next batch is read while the current one
+ * is splatted, memory is bounded by two batches and two images.
+ *
+ * @return the number of splatted particles, fewer after a read error
+ */
+size_t splatParticleFile( const ParticleFile& file, paramfile& params,
+                          arr2< COLOUR >& pic, const vec3& eye,
+                          const vec3& lookAt, const vec3& up,
+                          std::vector< COLOURMAP >& colorMaps );
+#endif
+
+}
+
+#endif
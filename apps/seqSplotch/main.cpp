@@ -27,6 +27,7 @@
  */
 
 #include "application.h"
+#include "movie.h"
 
 #ifdef SEQSPLOTCH_USE_QT5WIDGETS
 #  include <QApplication>
@@ -39,6 +40,11 @@
 
 int main( int argc, char** argv )
 {
+    // batch rendering needs no window and no Equalizer configuration
+    if( seqSplotch::Movie::isRequested( argc, argv ))
+        return seqSplotch::Movie( argc, argv ).run() ? EXIT_SUCCESS
+                                                     : EXIT_FAILURE;
+
     lunchbox::RefPtr< seqSplotch::Application > app( new seqSplotch::Application );
 
 #ifdef SEQSPLOTCH_USE_QT5WIDGETS
@@ -0,0 +1,309 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "kernels.h"
+#include "model.h"
+#include "tracer.h"
+
+#ifdef SEQSPLOTCH_USE_OSPRAY
+#  include "osprayRenderer.h"
+#endif
+
+#include <lunchbox/clock.h>
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace seqSplotch
+{
+namespace
+{
+struct Result
+{
+    std::string kernel;
+    size_t size;
+    std::vector< float > times;
+};
+
+std::vector< size_t > _parseSizes( const std::string& list )
+{
+    std::vector< size_t > sizes;
+    std::stringstream stream( list );
+    std::string item;
+    while( std::getline( stream, item, ',' ))
+        sizes.push_back( size_t( std::stod( item ))); // accepts 1e6
+    return sizes;
+}
+
+float _getMedian( std::vector< float > values )
+{
+    std::sort( values.begin(), values.end( ));
+    return values[values.size() / 2];
+}
+
+class MicroBenchmark
+{
+public:
+    explicit MicroBenchmark( const size_t repetitions )
+        : _repetitions( std::max( repetitions, size_t( 1 )))
+    {}
+
+    /** Time kernel after one untimed run, prepare is not timed. */
+    void run( const std::string& kernel, const size_t size,
+              const std::function< void() >& prepare,
+              const std::function< void() >& function )
+    {
+        Result result{ kernel, size, std::vector< float >( )};
+        prepare();
+        function();
+        for( size_t i = 0; i < _repetitions; ++i )
+        {
+            prepare();
+            _clock.reset();
+            function();
+            result.times.push_back( _clock.getTimef( ));
+        }
+        _results.push_back( result );
+        std::cerr << kernel << " " << size << ": "
+                  << _getMedian( result.times ) << " ms" << std::endl;
+    }
+
+    void write( std::ostream& os ) const
+    {
+        os << "{" << std::endl << "  \"kernels\": [" << std::endl;
+        for( size_t i = 0; i < _results.size(); ++i )
+        {
+            const Result& result = _results[i];
+            const float median = _getMedian( result.times );
+            const float min = *std::min_element( result.times.begin(),
+                                                 result.times.end( ));
+            os << "    {" << std::endl
+               << "      \"name\": \"" << result.kernel << "\"," << std::endl
+               << "      \"size\": " << result.size << "," << std::endl
+               << "      \"repetitions\": " << result.times.size() << ","
+               << std::endl
+               << "      \"time\": { \"min\": " << min << ", \"median\": "
+               << median << ", \"max\": "
+               << *std::max_element( result.times.begin(),
+                                     result.times.end( )) << " }," << std::endl
+               << "      \"itemsPerSecond\": "
+               << ( median > 0.f ? 1000.f * result.size / median : 0.f )
+               << std::endl
+               << "    }" << ( i + 1 < _results.size() ? "," : "" )
+               << std::endl;
+        }
+        os << "  ]" << std::endl << "}" << std::endl;
+    }
+
+private:
+    const size_t _repetitions;
+    lunchbox::Clock _clock;
+    std::vector< Result > _results;
+};
+
+void _benchmarkParticles( MicroBenchmark& benchmark, Model& model,
+                          const size_t size, const int resolution )
+{
+    const Model::Particles& particles = model.getParticles();
+
+    benchmark.run( "boundingSphere", size, []{}, [&]
+    {
+        computeBoundingSphere( particles );
+    });
+
+    Model::Particles filtered;
+    std::vector< size_t > numLevelParticles;
+    benchmark.run( "colorizeParticles", size, []{}, [&]
+    {
+        colorizeParticles( model, filtered, numLevelParticles );
+    });
+
+    std::vector< seq::Vector4f > positions( filtered.size( ));
+    std::vector< seq::Vector4f > colors( filtered.size( ));
+    benchmark.run( "fillParticleBuffers", size, []{}, [&]
+    {
+        fillParticleBuffers( filtered, positions.data(), colors.data( ));
+    });
+
+    std::vector< uint32_t > indices;
+    benchmark.run( "fillQuadIndices", size, []{}, [&]
+    {
+        fillQuadIndices( filtered.size(), indices );
+    });
+
+#ifdef SEQSPLOTCH_USE_OSPRAY
+    OSPRayRenderer renderer;
+    benchmark.run( "ospraySceneBuild", size, []{}, [&]
+    {
+        renderer.update( model );
+    });
+#endif
+
+#ifndef CUDA
+    // host_rendering works on its own copy, as in the renderer
+    paramfile& params = model.getParams();
+    params.setParam( "xres", resolution );
+    params.setParam( "yres", resolution );
+    const seq::Vector4f& sphere = model.getBoundingSphere();
+    const vec3 lookAt( sphere.x(), sphere.y(), sphere.z( ));
+    const vec3 eye = lookAt + vec3( 0.f, 0.f, sphere.w( ));
+    Model::Particles copy;
+    arr2< COLOUR > pic( resolution, resolution );
+    benchmark.run( "hostRendering", size, [&]
+    {
+        copy = particles;
+    }, [&]
+    {
+        host_rendering( params, copy, pic, eye, eye, lookAt,
+                        vec3( 0.f, 1.f, 0.f ), model.getColorMaps(),
+                        model.getBrightness(), copy.size( ));
+    });
+
+    // the colourised path of the new renderer, one eye against a stereo
+    // pair which projects and sorts once
+    Model::Particles colorized;
+    gatherParticles( particles, model.getVisibleRanges( 0 ), colorized );
+    colorParticles( params, colorized, model.getColorMaps(),
+                    model.getBrightness( ));
+    Model::Particles projected;
+    Model::Particles otherProjected;
+    arr2< COLOUR > otherPic( resolution, resolution );
+    const float eyeOffset = .03f * sphere.w();
+    benchmark.run( "splatMono", size, []{}, [&]
+    {
+        splatParticles( params, colorized, pic, eye, lookAt,
+                        vec3( 0.f, 1.f, 0.f ), 0.f, seq::Vector2i( 0, 0 ),
+                        projected );
+    });
+    benchmark.run( "splatStereo", size, []{}, [&]
+    {
+        splatStereo( params, colorized, pic, otherPic, eye, lookAt,
+                     vec3( 0.f, 1.f, 0.f ), eyeOffset, seq::Vector2i( 0, 0 ),
+                     projected, otherProjected );
+    });
+#endif
+}
+
+void _benchmarkImage( MicroBenchmark& benchmark, const int resolution )
+{
+    std::mt19937 rng( 0 );
+    std::uniform_real_distribution< float > value( 0.f, 4.f );
+    arr2< COLOUR > input( resolution, resolution );
+    for( int i = 0; i < resolution; ++i )
+        for( int j = 0; j < resolution; ++j )
+            input[i][j] = COLOUR( value( rng ), value( rng ), value( rng ));
+
+    paramfile::params_type values;
+    values["pic_gamma"] = "0.8";
+    paramfile params( values, false );
+
+    const size_t size = size_t( resolution ) * resolution;
+    arr2< COLOUR > pic( resolution, resolution );
+    benchmark.run( "toneMap", size, [&]
+    {
+        for( int i = 0; i < resolution; ++i )
+            for( int j = 0; j < resolution; ++j )
+                pic[i][j] = input[i][j];
+    }, [&]
+    {
+        toneMap( pic, params );
+    });
+
+    std::vector< float > pixels;
+    benchmark.run( "transposeImage", size, []{}, [&]
+    {
+        transposeImage( input, pixels );
+    });
+}
+}
+}
+
+int main( const int argc, char** argv )
+{
+    std::vector< size_t > sizes = { 10000, 100000, 1000000, 10000000 };
+    std::vector< size_t > resolutions = { 256, 512, 1024, 2048 };
+    std::string distribution = "plummer";
+    std::string output;
+    size_t repetitions = 10;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+        if( arg == "--help" || arg == "-h" )
+        {
+            std::cout << "Usage: " << argv[0] << " [--sizes n1,n2,...] "
+                      << "[--resolutions r1,r2,...] [--repetitions n] "
+                      << "[--distribution plummer|nfw|box|filaments] "
+                      << "[--output file] [--trace file]" << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if( i + 1 >= argc )
+            continue;
+        if( arg == "--sizes" )
+            sizes = seqSplotch::_parseSizes( argv[++i] );
+        else if( arg == "--resolutions" )
+            resolutions = seqSplotch::_parseSizes( argv[++i] );
+        else if( arg == "--repetitions" )
+            repetitions = std::stoul( argv[++i] );
+        else if( arg == "--distribution" )
+            distribution = argv[++i];
+        else if( arg == "--output" )
+            output = argv[++i];
+        else if( arg == "--trace" )
+            seqSplotch::Tracer::start( argv[++i] );
+    }
+
+#ifdef SEQSPLOTCH_USE_OSPRAY
+    int ospArgc = argc;
+    ospInit( &ospArgc, const_cast< const char** >( argv ));
+#endif
+
+    seqSplotch::MicroBenchmark benchmark( repetitions );
+    for( const size_t size : sizes )
+    {
+        seqSplotch::Model model( servus::URI( "synthetic://" + distribution +
+                                              "?particles=" +
+                                              std::to_string( size )));
+        seqSplotch::_benchmarkParticles( benchmark, model, size, 512 );
+    }
+    for( const size_t resolution : resolutions )
+        seqSplotch::_benchmarkImage( benchmark, int( resolution ));
+    seqSplotch::Tracer::stop();
+
+    if( output.empty( ))
+        benchmark.write( std::cout );
+    else
+    {
+        std::ofstream file( output.c_str( ));
+        benchmark.write( file );
+    }
+    return EXIT_SUCCESS;
+}
@@ -28,58 +28,293 @@
 
 #include "model.h"
 
+#include "kernels.h"
+#include "stats.h"
+#include "tracer.h"
+
+#include <lunchbox/log.h>
+
+#include <algorithm>
+
 namespace seqSplotch
 {
+namespace
+{
+// Level of a particle in the boost pyramid: every 2^level-th particle of the
+// original order is part of the given level and all finer ones.
+size_t _getLevel( const size_t index, const size_t numLevels )
+{
+    size_t level = 0;
+    for( size_t i = index; i > 0 && ( i & 1 ) == 0 && level+1 < numLevels;
+         i >>= 1 )
+    {
+        ++level;
+    }
+    return index == 0 ? numLevels - 1 : level;
+}
+
+const std::string _statsChannel( "model" );
+
+// Synthetic datasets and particle files have no parameter file, query items
+// which are not used by the generator override the rendering defaults.
+paramfile _createParams( const servus::URI& uri )
+{
+    if( !SyntheticSource::isSynthetic( uri ) &&
+        !ParticleFile::isParticleFile( uri ))
+    {
+        return paramfile( std::to_string( uri ), false );
+    }
+
+    paramfile::params_type params;
+    params["ptypes"] = "1";
+    params["brightness0"] = "1";
+    for( auto i = uri.queryBegin(); i != uri.queryEnd(); ++i )
+    {
+        if( i->first != "particles" && i->first != "seed" &&
+            i->first != "frames" )
+        {
+            params[i->first] = i->second;
+        }
+    }
+    return paramfile( params, false );
+}
+}
 
-Model::Model( const servus::URI& uri )
-    : _params( std::to_string( uri ), false )
-    , _sceneMaker( _params )
+Model::Model( const servus::URI& uri, Stats* stats,
+              const seq::Vector2f& range,
+              std::shared_ptr< SceneCache > sceneCache )
+    : _uri( uri )
+    , _stats( stats )
+    , _range( range )
+    , _params( _createParams( uri ))
+    , _sceneCache( sceneCache )
+    , _firstFrame( 0 )
+    , _windowSize( 0 )
+    , _numLevels( 1 )
     , _currentFrame( std::numeric_limits< size_t >::max( ))
     , _haveAll( false )
+    , _compact( false )
+    , _shownIndex( 0 )
+    , _decodedFrame( std::numeric_limits< size_t >::max( ))
+    , _blend( 0.f )
+    , _blending( false )
+    , _canBlend( false )
+    , _revision( 0 )
+    , _cameraPending( false )
+    , _drawFrame( 0 )
+    , _syncFrames( false )
 {
-    get_colourmaps( _params, _colorMaps );
-    _boost = _params.find< bool >( "boost", false );
+    if( SyntheticSource::isSynthetic( uri ))
+    {
+        _synthetic.reset( new SyntheticSource( uri ));
+        _synthetic->setRange( _range.x(), _range.y( ));
+        _pool.setFrameSize( _synthetic->getNumParticles( ));
+        _canBlend = true;
+        _colorMaps.assign( _params.find< int >( "ptypes", 1 ),
+                           SyntheticSource::getColorMap( ));
+    }
+    else if( ParticleFile::isParticleFile( uri ))
+    {
+        _particleFile.reset( new ParticleFile( uri.getPath(), _range.x(),
+                                               _range.y( )));
+        _pool.setFrameSize( std::min< size_t >(
+                                _params.find< int >( "ooc_preview", 1000000 ),
+                                _particleFile->getNumParticles( )));
+        _colorMaps.assign( _params.find< int >( "ptypes", 1 ),
+                           SyntheticSource::getColorMap( ));
+    }
+    else
+    {
+        if( _sceneCache )
+            _sceneCache->addReader();
+        else
+            _sceneMaker.reset( new sceneMaker( _params ));
+        get_colourmaps( _params, _colorMaps );
+    }
+    if( _params.find< bool >( "boost", false ))
+        _numLevels = std::max( _params.find< int >( "boost_levels", 4 ), 1 );
+
+    // the renderers may still draw the previous frame while the next loads
+    const int windowSize = _params.find< int >( "stream_frames", 0 );
+    if( windowSize > 0 )
+        _windowSize = std::max( windowSize, 2 );
 
     const unsigned numTypes = _params.find<int>( "ptypes", 1 );
     for( unsigned i = 0; i < numTypes; ++i )
         _colourIsVec.push_back( _params.find<bool>("color_is_vector" + dataToString(i), 0 ));
 
+    // quantized frames, about three times as many fit into memory
+    if( _params.find< bool >( "compact_frames", false ))
+    {
+        _compact = numTypes <= 256 &&
+                   std::find( _colourIsVec.begin(), _colourIsVec.end(),
+                              true ) == _colourIsVec.end();
+        if( !_compact )
+            LBWARN << "Ignoring compact_frames, it needs scalar colours and "
+                   << "at most 256 particle types" << std::endl;
+    }
+
     loadNextFrame();
 }
 
+Model::~Model()
+{
+    _cancelPrefetch();
+    if( _sceneCache )
+        _sceneCache->removeReader();
+}
+
+bool Model::isValid() const
+{
+    return ( !_synthetic || _synthetic->isValid( )) &&
+           ( !_particleFile || _particleFile->isValid( ));
+}
+
 void Model::loadNextFrame()
 {
-    _currentFrame = _currentFrame == std::numeric_limits< size_t >::max()
+    Tracer::Span span( "Model::loadNextFrame" );
+    _blend = 0.f; // a step shows the plain frame
+    const size_t next = _currentFrame == std::numeric_limits< size_t >::max()
             ? 0 : _currentFrame+1;
-    bool isEOF = _currentFrame >= _particles.size();
+    if( next < _firstFrame + _frames.size( ))
+    {
+        // the frame loaded ahead to blend towards it has the camera to use
+        if( _cameraPending && next + 1 == _firstFrame + _frames.size( ))
+            _applyCamera( _frames.back( ));
+        _currentFrame = next;
+        _updateCurrentFrame();
+        return;
+    }
+
+    if( _haveAll )
+    {
+        _currentFrame = 0;
+        _updateCurrentFrame();
+        return;
+    }
+
+    if( !_appendFrame( ))
+    {
+        if( _windowSize == 0 )
+        {
+            _haveAll = true;
+            _currentFrame = 0;
+            _updateCurrentFrame();
+        }
+        else if( next > 0 ) // start over, unless the data is empty
+            _restart();
+        return;
+    }
+
+    _applyCamera( _frames.back( ));
+    _currentFrame = next;
+    _updateCurrentFrame();
+}
 
-    if( !_haveAll )
+void Model::setFrameIndex( const size_t index )
+{
+    if( index == _currentFrame )
+        return;
+
+    if( index < _firstFrame )
+        _restart();
+
+    // skipped frames are only loaded, the target frame is decoded once below
+    while( !_haveAll && index >= _firstFrame + _frames.size( ))
     {
-        std::string outfile;
-        vec3 centerPos;
-        Particles particles, points;
-        isEOF = !_sceneMaker.getNextScene( particles, points, _cameraPosition,
-                                           centerPos, _lookAt, _up, outfile );
-        if( !isEOF )
+        _currentFrame = _firstFrame + _frames.size() - 1; // slide the window
+        if( _appendFrame( ))
         {
-            _particles.emplace_back( particles );
-            _points.emplace_back( points );
+            _applyCamera( _frames.back( ));
+            continue;
         }
+
+        if( _windowSize == 0 )
+            _haveAll = true;
         else
+            _restart();
+        break;
+    }
+
+    _currentFrame = std::max( _firstFrame, std::min( index,
+                                  _firstFrame + _frames.size() - 1 ));
+    _updateCurrentFrame();
+}
+
+void Model::setFrameTime( const size_t index, float blend )
+{
+    blend = std::max( 0.f, std::min( blend, 1.f ));
+    if( index == _currentFrame && blend == _blend )
+        return;
+
+    // the plain frame first, blended once below
+    _blend = 0.f;
+    setFrameIndex( index );
+    if( blend > 0.f && !_haveAll &&
+        _currentFrame + 1 == _firstFrame + _frames.size( ))
+    {
+        if( _appendFrame( ))
+            _cameraPending = true;
+        else if( _windowSize == 0 ) // all frames are loaded
             _haveAll = true;
     }
 
-    if( isEOF )
-        _currentFrame = 0;
+    _blend = blend;
+    if( _blend > 0.f || _blending )
+        _updateCurrentFrame();
+}
+
+void Model::prefetch( const size_t index )
+{
+    // a particle file has a single frame, which is loaded in the constructor
+    if( _prefetch.valid() || _haveAll || _particleFile ||
+        index != _firstFrame + _frames.size( ))
+    {
+        return;
+    }
+
+    _prefetchFrame = _newFrame();
+    _prefetch = std::async( std::launch::async,
+                            [this] { return _loadFrame( _prefetchFrame ); });
+}
 
-    _brightness = _boost ? float(_particles.size())/float(_points.size()) : 1.0;
+void Model::syncFrames( const uint32_t current, const uint32_t finished )
+{
+    _syncFrames = true;
+    _drawFrame = current;
+    while( !_retired.empty() && _retired.front().second <= finished )
+    {
+        _releaseFrame( _retired.front().first );
+        _retired.pop_front();
+    }
+}
 
-    _computeBoundingSphere();
+void Model::setWindowSize( const size_t size )
+{
+    // the renderers may still draw the previous frame while the next loads
+    _windowSize = size > 0 ? std::max( size, size_t( 2 )) : 0;
 }
 
 const Model::Particles& Model::getParticles() const
 {
-    return _boost ? _points[_currentFrame] : _particles[_currentFrame];
+    static const Particles empty;
+    if( _frames.empty( ))
+        return empty;
+    if( _blending || _compact )
+        return _shown[_shownIndex];
+    return _frames[_currentFrame - _firstFrame].particles;
+}
+
+size_t Model::getNumLevels() const
+{
+    return _numLevels;
+}
+
+size_t Model::getNumParticles( const size_t level ) const
+{
+    const size_t numParticles = getParticles().size();
+    const size_t stride = size_t( 1 ) << std::min( level, _numLevels - 1 );
+    return ( numParticles + stride - 1 ) / stride;
 }
 
 seq::Matrix4f Model::getModelMatrix() const
@@ -105,9 +340,12 @@ std::vector< COLOURMAP >& Model::getColorMaps()
     return _colorMaps;
 }
 
-float Model::getBrightness() const
+float Model::getBrightness( const size_t level ) const
 {
-    return _brightness;
+    const size_t numParticles = getNumParticles( level );
+    if( numParticles == 0 )
+        return 1.f;
+    return float( getParticles().size( )) / float( numParticles );
 }
 
 const std::vector<bool>& Model::getColourIsVec() const
@@ -115,27 +353,345 @@ const std::vector<bool>& Model::getColourIsVec() const
     return _colourIsVec;
 }
 
+size_t Model::getNumTypes() const
+{
+    return std::max( _colourIsVec.size(), size_t( 1 ));
+}
+
+Model::Ranges Model::getVisibleRanges( const uint32_t hiddenTypes,
+                                       const size_t level ) const
+{
+    Ranges ranges;
+    if( _frames.empty( ))
+        return ranges;
+
+    // hidden buckets are skipped, adjacent visible ones are merged
+    const std::vector< size_t >& buckets =
+        _frames[_currentFrame - _firstFrame].buckets;
+    const size_t numTypes = getNumTypes();
+    const size_t end = getNumParticles( level );
+    for( size_t i = 0; i + 1 < buckets.size(); ++i )
+    {
+        const size_t type = i % numTypes;
+        if( type < 32 && ( hiddenTypes >> type ) & 1u )
+            continue;
+
+        const size_t first = buckets[i];
+        const size_t last = std::min( buckets[i+1], end );
+        if( first >= last )
+            continue;
+        if( !ranges.empty() && ranges.back().second == first )
+            ranges.back().second = last;
+        else
+            ranges.emplace_back( first, last );
+    }
+    return ranges;
+}
+
 size_t Model::getFrameIndex() const
 {
     return _currentFrame;
 }
 
-void Model::_computeBoundingSphere()
+size_t Model::getRevision() const
+{
+    return _revision;
+}
+
+bool Model::canBlend() const
+{
+    return _canBlend;
+}
+
+const seq::Vector2f& Model::getRange() const
+{
+    return _range;
+}
+
+const ParticleFile* Model::getParticleFile() const
+{
+    return _particleFile.get();
+}
+
+void Model::_updateCurrentFrame()
+{
+    // Renderers may still draw the previous frame, decode or blend into the
+    // other buffer. Compact frames are blended while decoding them.
+    if( !_interpolate() && _compact && !_frames.empty() &&
+        _decodedFrame != _currentFrame )
+    {
+        _shownIndex = 1 - _shownIndex;
+        _frames[_currentFrame - _firstFrame].compact.decode(
+            _shown[_shownIndex] );
+        _decodedFrame = _currentFrame;
+    }
+    _boundingSphere = computeBoundingSphere( getParticles( ));
+    ++_revision;
+}
+
+bool Model::_interpolate()
+{
+    _blending = false;
+    if( !_canBlend || _blend <= 0.f ||
+        _currentFrame + 1 >= _firstFrame + _frames.size( ))
+    {
+        return false;
+    }
+
+    const Frame& current = _frames[_currentFrame - _firstFrame];
+    const Frame& next = _frames[_currentFrame + 1 - _firstFrame];
+    if( _compact ? current.compact.size() != next.compact.size()
+                 : current.particles.size() != next.particles.size( ))
+    {
+        return false;
+    }
+
+    Tracer::Span span( "Model::interpolate" );
+    const bool attributes = _params.find< bool >( "interpolate_attributes",
+                                                  false );
+    _shownIndex = 1 - _shownIndex;
+    _decodedFrame = std::numeric_limits< size_t >::max();
+    if( _compact )
+        current.compact.decode( next.compact, _blend, attributes,
+                                _shown[_shownIndex] );
+    else
+        interpolateParticles( current.particles, next.particles, _blend,
+                              attributes, _shown[_shownIndex] );
+    _blending = true;
+    return true;
+}
+
+bool Model::_appendFrame()
+{
+    Frame frame;
+    bool isEOF = false;
+    if( _prefetch.valid( ))
+    {
+        isEOF = !_prefetch.get();
+        frame = std::move( _prefetchFrame );
+    }
+    else
+    {
+        frame = _newFrame();
+        isEOF = !_loadFrame( frame );
+    }
+
+    if( isEOF )
+    {
+        _releaseFrame( frame );
+        return false;
+    }
+
+    _frames.emplace_back( std::move( frame ));
+    if( _windowSize > 0 && _frames.size() > _windowSize &&
+        _firstFrame != _currentFrame ) // still shown, dropped next time
+    {
+        _retireFrame( _frames.front( ));
+        _frames.pop_front();
+        ++_firstFrame;
+    }
+    return true;
+}
+
+void Model::_applyCamera( const Frame& frame )
+{
+    _cameraPosition = frame.cameraPosition;
+    _lookAt = frame.lookAt;
+    _up = frame.up;
+    _cameraPending = false;
+}
+
+void Model::_releaseFrame( Frame& frame )
+{
+    _pool.release( std::move( frame.particles ));
+    frame.compact.clear();
+}
+
+void Model::_retireFrame( Frame& frame )
+{
+    if( _syncFrames )
+        _retired.emplace_back( std::move( frame ), _drawFrame );
+    else
+        _releaseFrame( frame );
+}
+
+Model::Frame Model::_newFrame()
+{
+    // sources without a camera per frame keep the current one
+    Frame frame;
+    frame.index = _firstFrame + _frames.size();
+    frame.cameraPosition = _cameraPosition;
+    frame.lookAt = _lookAt;
+    frame.up = _up;
+
+    // encoding a copy keeps the columns which did not change shared
+    if( _compact && !_frames.empty( ))
+        frame.compact = _frames.back().compact;
+    return frame;
+}
+
+bool Model::_loadFrame( Frame& frame )
+{
+    Stats::Timer timer( _stats, _statsChannel, Stats::STAGE_LOAD );
+
+    // on the loading thread, a new buffer is reserved and touched here
+    frame.particles = _pool.acquire();
+    if( !_loadScene( frame ))
+        return false;
+    _sortParticles( frame );
+    if( _compact )
+    {
+        frame.compact.encode( frame.particles );
+        _pool.release( std::move( frame.particles ));
+    }
+    return true;
+}
+
+bool Model::_loadScene( Frame& frame )
 {
-    if( getParticles().empty( ))
+    Particles& particles = frame.particles;
+    if( _synthetic )
+        return _synthetic->getNextScene( particles, frame.cameraPosition,
+                                         frame.lookAt, frame.up );
+
+    if( _particleFile )
+    {
+        if( !_frames.empty( )) // a single frame
+            return false;
+
+        if( !_particleFile->readSubset( _params.find< int >( "ooc_preview",
+                                                             1000000 ),
+                                        particles ))
+        {
+            return false;
+        }
+        const seq::Vector4f sphere = computeBoundingSphere( particles );
+        frame.lookAt = vec3( sphere.x(), sphere.y(), sphere.z( ));
+        frame.cameraPosition = frame.lookAt + vec3( 0.f, 0.f, sphere.w( ));
+        frame.up = vec3( 0.f, 1.f, 0.f );
+        return true;
+    }
+
+    // the range models of a node share the snapshot and copy their part
+    if( _sceneCache )
+    {
+        if( !_sceneCache->getScene( frame.index, _range, particles,
+                                    frame.cameraPosition, frame.lookAt,
+                                    frame.up ))
+        {
+            return false;
+        }
+        _pool.setFrameSize( particles.size( ));
+        return true;
+    }
+
+    // The readers size the frame buffer from the header of the snapshot. It
+    // is a pool buffer, which has the size and the placed pages of the
+    // previous snapshot already.
+    std::string outfile;
+    vec3 centerPos;
+    Particles points;
+    if( !_sceneMaker->getNextScene( particles, points, frame.cameraPosition,
+                                    centerPos, frame.lookAt, frame.up,
+                                    outfile ))
     {
-        _boundingSphere = seq::Vector4f( 0, 0, 0, 1 );
+        return false;
+    }
+    _pool.setFrameSize( particles.size( ));
+
+    // the readers have no partial loading, keep only the range
+    const size_t size = particles.size();
+    const size_t first = size_t( _range.x() * float( size ));
+    const size_t last = _range.y() >= 1.f ? size :
+                        std::max( first, size_t( _range.y() * float( size )));
+    if( first > 0 )
+        std::copy( particles.begin() + first, particles.begin() + last,
+                   particles.begin( ));
+    particles.resize( last - first );
+    return true;
+}
+
+void Model::_cancelPrefetch()
+{
+    if( !_prefetch.valid( ))
         return;
+    _prefetch.get();
+    _releaseFrame( _prefetchFrame );
+}
+
+void Model::_restart()
+{
+    _cancelPrefetch();
+    if( _synthetic )
+    {
+        _synthetic.reset( new SyntheticSource( _uri ));
+        _synthetic->setRange( _range.x(), _range.y( ));
     }
+    else if( _sceneMaker )
+        _sceneMaker.reset( new sceneMaker( _params ));
 
-    BoundingBox bbox;
-    bbox.Compute( getParticles( ));
+    for( Frame& frame : _frames )
+        _retireFrame( frame );
+    _frames.clear();
+    _decodedFrame = std::numeric_limits< size_t >::max();
+    _cameraPending = false;
+    _firstFrame = 0;
+    _currentFrame = std::numeric_limits< size_t >::max();
+    loadNextFrame();
+}
+
+void Model::_sortParticles( Frame& frame )
+{
+    // Bucket sort by level, coarsest level first, so that each level is a
+    // prefix of the frame and a stride-2^level subsample of the loaded
+    // particles. Within a level the particles are sorted by type. The sort
+    // is in place and not stable, only the buckets are kept aside.
+    Particles& particles = frame.particles;
+    const size_t numTypes = getNumTypes();
+    const size_t numBuckets = _numLevels * numTypes;
+    std::vector< size_t >& buckets = frame.buckets;
+    buckets.assign( numBuckets + 1, 0 );
+    buckets.back() = particles.size();
+    if( numBuckets < 2 || particles.empty( ))
+        return;
+
+    const auto getBucket = [&]( const size_t i )
+    {
+        const size_t type = std::min< size_t >( particles[i].type,
+                                                numTypes - 1 );
+        return ( _numLevels - 1 - _getLevel( i, _numLevels )) * numTypes +
+               type;
+    };
+
+    std::vector< uint32_t > keys( particles.size( ));
+    const int64_t numParticles = particles.size();
+#pragma omp parallel for schedule( static )
+    for( int64_t i = 0; i < numParticles; ++i )
+        keys[i] = uint32_t( getBucket( i ));
 
-    const seq::Vector3f minExtend( bbox.minX, bbox.minY, bbox.minZ );
-    const seq::Vector3f maxExtend( bbox.maxX, bbox.maxY, bbox.maxZ );
+    for( const uint32_t key : keys )
+        ++buckets[key + 1];
+    for( size_t i = 1; i < buckets.size(); ++i )
+        buckets[i] += buckets[i-1];
 
-    _boundingSphere.set_sub_vector< 3, 0 >( (minExtend + maxExtend) / 2.f );
-    _boundingSphere.w() = minExtend.distance( maxExtend );
+    // each misplaced particle is swapped to the next free slot of its bucket
+    std::vector< size_t > next( buckets.begin(), buckets.end() - 1 );
+    for( size_t bucket = 0; bucket < numBuckets; ++bucket )
+    {
+        while( next[bucket] < buckets[bucket + 1] )
+        {
+            const size_t i = next[bucket];
+            const uint32_t key = keys[i];
+            if( key == bucket )
+            {
+                ++next[bucket];
+                continue;
+            }
+            const size_t j = next[key]++;
+            std::swap( particles[i], particles[j] );
+            std::swap( keys[i], keys[j] );
+        }
+    }
 }
 
 }
@@ -29,52 +29,209 @@
 #ifndef SEQ_SPLOTCH_MODEL_H
 #define SEQ_SPLOTCH_MODEL_H
 
+#include "compactFrame.h"
+#include "framePool.h"
+#include "particleFile.h"
+#include "sceneCache.h"
+#include "synthetic.h"
+#include "types.h"
+
 #include <seq/sequel.h>
 
+#include <deque>
+#include <future>
+
 #include <splotch/scenemaker.h>
 #include <splotch/splotch_host.h>
 
 namespace seqSplotch
 {
 
+/**
+ * The particle frames of a time series.
+ *
+ * All frames stay in memory once loaded, unless the stream_frames parameter
+ * limits them to a sliding window of the most recent frames. The data source
+ * is then restarted to go back to earlier frames. Frames dropped from the
+ * window are freed once the renderers are done with them, see syncFrames().
+ */
 class Model
 {
 public:
-    explicit Model( const servus::URI& uri );
+    /**
+     * @param stats optional, receives the frame load times
+     * @param range the fraction of the particles of each frame to load
+     * @param sceneCache optional, reads the snapshots of a Splotch parameter
+     *        file once for all range models of the node
+     */
+    explicit Model( const servus::URI& uri, Stats* stats = nullptr,
+                    const seq::Vector2f& range = seq::Vector2f( 0.f, 1.f ),
+                    std::shared_ptr< SceneCache > sceneCache = nullptr );
+    ~Model();
+
+    /** @return false if the data source could not be opened. */
+    bool isValid() const;
 
     void loadNextFrame();
 
-    typedef std::vector< particle_sim > Particles;
+    /** Load frames up to index, clamped to the last frame of the data. */
+    void setFrameIndex( size_t index );
+
+    /**
+     * Show the frame index with the particles blended towards the next frame
+     * by blend in [0, 1), which is loaded if needed. Particles are matched by
+     * their ID, frames without IDs are not blended, see canBlend(). The
+     * attributes are blended too with the interpolate_attributes parameter.
+     */
+    void setFrameTime( size_t index, float blend );
+
+    /**
+     * @return true if the frames have particle IDs to blend them. Synthetic
+     *         particles are generated in the order of their ID in every
+     *         frame. The Splotch readers drop the IDs and may reorder the
+     *         particles between snapshots, their interpolation_mode matches
+     *         them while reading.
+     */
+    bool canBlend() const;
+
+    /**
+     * Load the given frame in the background, if it is the next one of the
+     * data source. loadNextFrame() and setFrameIndex() pick it up.
+     */
+    void prefetch( size_t index );
+
+    /**
+     * Defer freeing the frames dropped from the window until the renderers
+     * have finished drawing them.
+     *
+     * Frames dropped from now on may be drawn up to the current config frame,
+     * frames dropped before are freed up to the finished config frame. Until
+     * the first call, dropped frames are freed immediately.
+     */
+    void syncFrames( uint32_t current, uint32_t finished );
+
+    /**
+     * Keep at most size frames from now on, like the stream_frames
+     * parameter. 0 keeps all frames.
+     */
+    void setWindowSize( size_t size );
+
+    typedef FramePool::Particles Particles;
     const Particles& getParticles() const;
 
+    /** @return the number of levels of the boost pyramid, 1 if disabled. */
+    size_t getNumLevels() const;
+
+    /**
+     * @return the number of particles of the given pyramid level. A level is
+     *         the first getNumParticles( level ) particles of getParticles().
+     */
+    size_t getNumParticles( size_t level = 0 ) const;
+
+    /** @return the number of particle types, the ptypes parameter. */
+    size_t getNumTypes() const;
+
+    typedef std::vector< std::pair< size_t, size_t > > Ranges;
+
+    /**
+     * @return the [first, last) ranges of the first getNumParticles( level )
+     *         particles which are not of the hidden types, a bit mask of the
+     *         first 32 types. Frames are sorted by type within each level, a
+     *         type is one range per level.
+     */
+    Ranges getVisibleRanges( uint32_t hiddenTypes, size_t level = 0 ) const;
+
     seq::Matrix4f getModelMatrix() const;
     const seq::Vector4f& getBoundingSphere() const;
 
     paramfile& getParams();
     std::vector< COLOURMAP >& getColorMaps();
-    float getBrightness() const;
+    float getBrightness( size_t level = 0 ) const;
     const std::vector<bool>& getColourIsVec() const;
 
     size_t getFrameIndex() const;
 
-private:
-    void _computeBoundingSphere();
+    /** @return a counter which changes with the content of getParticles(). */
+    size_t getRevision() const;
 
-    paramfile _params;
-    sceneMaker _sceneMaker;
+    /** @return the fraction of the particles of each frame held. */
+    const seq::Vector2f& getRange() const;
 
-    std::vector< Particles > _particles;
-    std::vector< Particles > _points;
+    /**
+     * @return the file of a frame too large for memory, nullptr otherwise.
+     *         getParticles() is then a subset of it for the bounding sphere
+     *         and the interactive renderers.
+     */
+    const ParticleFile* getParticleFile() const;
+
+private:
+    struct Frame
+    {
+        Particles particles;
+        CompactFrame compact; // instead of particles with compact_frames
+        std::vector< size_t > buckets; // begin of each level and type
+        size_t index; // in the data source
+        vec3 cameraPosition;
+        vec3 lookAt;
+        vec3 up;
+    };
+
+    void _updateCurrentFrame();
+    bool _interpolate();
+    bool _appendFrame();
+    void _applyCamera( const Frame& frame );
+    void _releaseFrame( Frame& frame );
+    void _retireFrame( Frame& frame );
+    void _sortParticles( Frame& frame );
+    Frame _newFrame();
+    bool _loadFrame( Frame& frame );
+    bool _loadScene( Frame& frame );
+    void _cancelPrefetch();
+    void _restart();
+
+    const servus::URI _uri;
+    Stats* const _stats;
+    const seq::Vector2f _range;
+    paramfile _params;
+    std::unique_ptr< sceneMaker > _sceneMaker;
+    std::shared_ptr< SceneCache > _sceneCache;
+    std::unique_ptr< SyntheticSource > _synthetic;
+    std::unique_ptr< ParticleFile > _particleFile;
+
+    std::deque< Frame > _frames;
+    size_t _firstFrame; // frame index of _frames.front()
+    size_t _windowSize; // 0 if all frames are kept
+    FramePool _pool;
     std::vector< COLOURMAP > _colorMaps;
     vec3 _cameraPosition;
     vec3 _lookAt;
     vec3 _up;
-    bool _boost;
-    float _brightness;
+    size_t _numLevels;
     seq::Vector4f _boundingSphere;
     std::vector<bool> _colourIsVec;
     size_t _currentFrame;
     bool _haveAll;
+    bool _compact;
+    // the current decoded or blended frame and the previous one, which the
+    // renderers may still draw
+    Particles _shown[2];
+    size_t _shownIndex;
+    size_t _decodedFrame; // in _shown unblended
+
+    float _blend;
+    bool _blending; // _blend applies to the current frame
+    bool _canBlend;
+    size_t _revision;
+    bool _cameraPending; // of the frame appended to blend towards
+
+    // frames dropped from the window and the last config frame drawing them
+    std::deque< std::pair< Frame, uint32_t > > _retired;
+    uint32_t _drawFrame;
+    bool _syncFrames;
+
+    // last member, waits for the load to finish before the others are gone
+    Frame _prefetchFrame;
+    std::future< bool > _prefetch;
 };
 
 }
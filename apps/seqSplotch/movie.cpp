@@ -0,0 +1,214 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "movie.h"
+
+#include "arguments.h"
+#include "cameraPath.h"
+#include "imageWriter.h"
+#include "kernels.h"
+#include "model.h"
+#include "tracer.h"
+
+#include <cmath>
+#include <future>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/stat.h>
+
+namespace seqSplotch
+{
+
+bool Movie::isRequested( const int argc, char** argv )
+{
+    for( int i = 1; i < argc; ++i )
+        if( strcmp( argv[i], "--movie" ) == 0 )
+            return true;
+    return false;
+}
+
+Movie::Movie( const int argc, char** argv )
+    : _directory( "." )
+    , _width( 1920 )
+    , _height( 1080 )
+    , _numWriters( 4 )
+    , _valid( true )
+{
+    for( int i = 1; i < argc; ++i )
+    {
+        if( i+1 >= argc )
+            break;
+        if( strcmp( argv[i], "--paramfile" ) == 0 )
+            _paramfile = argv[++i];
+        else if( strcmp( argv[i], "--movie" ) == 0 )
+            _directory = argv[++i];
+        else if( strcmp( argv[i], "--playback" ) == 0 )
+            _playback = argv[++i];
+        else if( strcmp( argv[i], "--movie-writers" ) == 0 )
+        {
+            if( !parseCount( argv[++i], _numWriters ))
+            {
+                LBERROR << "Invalid --movie-writers " << argv[i] << std::endl;
+                _valid = false;
+            }
+        }
+        else if( strcmp( argv[i], "--trace" ) == 0 )
+            Tracer::start( argv[++i] );
+        else if( strcmp( argv[i], "--resolution" ) == 0 )
+        {
+            if( !parseResolution( argv[++i], _width, _height ))
+            {
+                LBERROR << "Invalid --resolution " << argv[i] << std::endl;
+                _valid = false;
+            }
+        }
+    }
+}
+
+bool Movie::run()
+{
+    // once the model and the writers are gone, no thread records anymore
+    const bool result = _render();
+    Tracer::stop();
+    return result;
+}
+
+bool Movie::_render()
+{
+#ifdef CUDA
+    LBERROR << "Movie rendering needs the CPU Splotch renderer" << std::endl;
+    return false;
+#else
+    if( !_valid )
+        return false;
+    if( _paramfile.empty( ))
+    {
+        LBERROR << "Movie needs a --paramfile" << std::endl;
+        return false;
+    }
+    ::mkdir( _directory.c_str(), 0755 );
+
+    std::unique_ptr< CameraPath > path;
+    if( !_playback.empty( ))
+    {
+        path.reset( new CameraPath );
+        if( !path->load( _playback ) || path->getNumFrames() == 0 )
+            return false;
+    }
+
+    // each frame is rendered once, only the next one is loaded ahead
+    Model model( servus::URI( _paramfile ));
+    if( !model.isValid( ))
+        return false;
+    if( model.getParams().find< int >( "stream_frames", 0 ) <= 0 )
+        model.setWindowSize( 2 );
+    if( path )
+        model.setFrameIndex( path->getFrame( 0 ).modelFrame );
+
+    // The camera of a channel of the default config: a cyclop eye at the
+    // origin, one meter in front of a wall of one meter height. The wall has
+    // the aspect ratio of the movie.
+    const seq::Matrix4f viewMatrix( seq::Matrix4f::IDENTITY );
+    const float fov = 360.f / float( M_PI ) *
+                      std::atan( .5f * float( _width ) / float( _height ));
+
+    ImageWriter writer( _numWriters );
+    lunchbox::Clock clock;
+    Model::Particles particles; // reused, its pages stay on their NUMA node
+    for( size_t frame = 0; ; ++frame )
+    {
+        // everything the render needs from the model, as the loader changes it
+        const seq::Matrix4f modelMatrix = path ?
+                                          path->getFrame( frame ).modelMatrix :
+                                          model.getModelMatrix();
+        const size_t modelFrame = model.getFrameIndex();
+        const float brightness = model.getBrightness();
+        paramfile params = model.getParams();
+        copyParticles( model.getParticles().data(),
+                       model.getParticles().size(), particles ); // in place
+
+        std::future< bool > next = std::async( std::launch::async, [&]
+        {
+            Tracer::Span span( "Movie::load" );
+            if( path )
+            {
+                if( frame + 1 >= path->getNumFrames( ))
+                    return false;
+                model.setFrameIndex( path->getFrame( frame + 1 ).modelFrame );
+                return true;
+            }
+            model.loadNextFrame();
+            return model.getFrameIndex() > modelFrame; // false when wrapped
+        });
+
+        std::vector< float > pixels;
+        {
+            Tracer::Span span( "Movie::render" );
+            seq::Matrix4f modelView = viewMatrix * modelMatrix;
+            modelView( 3, 2 ) = -modelView( 3, 2 );
+            seq::Vector3f origin, lookAt, up;
+            modelView.getLookAt( origin, lookAt, up );
+            const vec3 eye( origin.x(), origin.y(), origin.z( ));
+
+            params.setParam( "xres", _width );
+            params.setParam( "yres", _height );
+            params.setParam( "fov", int( fov ));
+            arr2< COLOUR > pic( _width, _height );
+            if( model.getParticleFile( ))
+                splatParticleFile( *model.getParticleFile(), params, pic, eye,
+                                   vec3( lookAt.x(), lookAt.y(), lookAt.z( )),
+                                   vec3( up.x(), up.y(), up.z( )),
+                                   model.getColorMaps( ));
+            else
+                host_rendering( params, particles, pic, eye, eye,
+                                vec3( lookAt.x(), lookAt.y(), lookAt.z( )),
+                                vec3( up.x(), up.y(), up.z( )),
+                                model.getColorMaps(), brightness,
+                                particles.size( ));
+            toneMap( pic, params );
+            transposeImage( pic, pixels );
+        }
+
+        std::ostringstream filename;
+        filename << _directory << "/frame_" << std::setw( 5 )
+                 << std::setfill( '0' ) << frame << ".ppm";
+        writer.write( filename.str(), pixels, _width, _height );
+
+        if( !next.get( ))
+        {
+            writer.flush();
+            LBINFO << "Rendered " << frame + 1 << " frames in "
+                   << clock.getTimef() / 1000.f << " s" << std::endl;
+            return true;
+        }
+    }
+#endif
+}
+
+}
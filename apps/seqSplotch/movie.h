@@ -0,0 +1,74 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_MOVIE_H
+#define SEQ_SPLOTCH_MOVIE_H
+
+#include <string>
+
+namespace seqSplotch
+{
+
+/**
+ * Offscreen batch rendering of all frames of a model, or of a recorded
+ * camera path, to PPM images with the Splotch CPU renderer.
+ *
+ * Loading the next frame, rendering the current one and encoding the
+ * previous ones overlap: the next frame is loaded asynchronously and images
+ * are written by a pool of encoder threads.
+ */
+class Movie
+{
+public:
+    /** @return true if --movie is given on the command line. */
+    static bool isRequested( int argc, char** argv );
+
+    /**
+     * Takes --paramfile <uri>, --movie <directory>, --playback <path>,
+     * --resolution <width>x<height>, --movie-writers <n> and --trace <file>.
+     */
+    Movie( int argc, char** argv );
+
+    /** Render all frames, @return false on error. */
+    bool run();
+
+private:
+    bool _render();
+
+    std::string _paramfile;
+    std::string _directory;
+    std::string _playback;
+    int _width;
+    int _height;
+    size_t _numWriters;
+    bool _valid; // false after an invalid argument
+};
+
+}
+
+#endif
@@ -29,6 +29,7 @@
 #include "osprayRenderer.h"
 
 #include "model.h"
+#include "tracer.h"
 
 #include <eq/gl.h>
 
@@ -50,8 +51,9 @@ OSPRayRenderer::~OSPRayRenderer()
 
 }
 
-void OSPRayRenderer::update( Model& model )
+void OSPRayRenderer::update( Model& model, const uint32_t hiddenTypes )
 {
+    Tracer::Span span( "OSPRayRenderer::update" );
     if( !_renderer )
     {
         _renderer = ospNewRenderer( "obj" );
@@ -89,26 +91,31 @@ void OSPRayRenderer::update( Model& model )
     materials.reserve( model.getParticles().size( ));
     std::vector< seq::Vector4f > colors;
     colors.reserve( model.getParticles().size( ));
-    for( const auto& i : model.getParticles( ))
+    const auto& particles = model.getParticles();
+    for( const auto& range : model.getVisibleRanges( hiddenTypes ))
     {
-        if( i.r <= std::numeric_limits< float >::epsilon( ))
-            continue;
-
-        auto it = std::find( colors.begin(), colors.end(), seq::Vector4f( i.e.r, i.e.g, i.e.b, i.I ));
-        int matIdx;
-        if( it == colors.end( ))
+        for( size_t index = range.first; index < range.second; ++index )
         {
-            OSPMaterial mat = ospNewMaterial( _renderer, "OBJMaterial" );
-            ospSet3fv( mat, "Kd", &i.e.r );
-            ospSet1f( mat, "d", 0.2 * i.I );
-            ospCommit( mat );
-            materials.push_back( mat );
-            matIdx = colors.size();
-            colors.push_back( seq::Vector4f( i.e.r, i.e.g, i.e.b, i.I ));
+            const auto& i = particles[index];
+            if( i.r <= std::numeric_limits< float >::epsilon( ))
+                continue;
+
+            auto it = std::find( colors.begin(), colors.end(), seq::Vector4f( i.e.r, i.e.g, i.e.b, i.I ));
+            int matIdx;
+            if( it == colors.end( ))
+            {
+                OSPMaterial mat = ospNewMaterial( _renderer, "OBJMaterial" );
+                ospSet3fv( mat, "Kd", &i.e.r );
+                ospSet1f( mat, "d", 0.2 * i.I );
+                ospCommit( mat );
+                materials.push_back( mat );
+                matIdx = colors.size();
+                colors.push_back( seq::Vector4f( i.e.r, i.e.g, i.e.b, i.I ));
+            }
+            else
+                matIdx = std::distance( colors.begin(), it );
+            atoms.emplace_back( Atom { vec3f( i.x, i.y, i.z ), i.r, matIdx } );
         }
-        else
-            matIdx = std::distance( colors.begin(), it );
-        atoms.emplace_back( Atom { vec3f( i.x, i.y, i.z ), i.r, matIdx } );
     }
     OSPData materialData = ospNewData( materials.size(), OSP_OBJECT,
                                        materials.data( ));
@@ -215,7 +222,10 @@ bool OSPRayRenderer::render( const seq::Vector2i& size,
 
     ospCommit( _camera );
 
-    ospRenderFrame( _fb, _renderer, OSP_FB_COLOR | OSP_FB_ACCUM );
+    {
+        Tracer::Span span( "ospRenderFrame" );
+        ospRenderFrame( _fb, _renderer, OSP_FB_COLOR | OSP_FB_ACCUM );
+    }
 
     uint32_t* ucharFB = (uint32_t *)ospMapFrameBuffer( _fb );
 
@@ -43,7 +43,7 @@ public:
     OSPRayRenderer();
     ~OSPRayRenderer();
 
-    void update( Model& model );
+    void update( Model& model, uint32_t hiddenTypes = 0 );
     void updateCamera( Camera mode );
     bool render( const seq::Vector2i& size, const seq::Matrix4f& matrix,
                  const float fovy );
@@ -0,0 +1,209 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "particleFile.h"
+
+#include "framePool.h"
+
+#include <lunchbox/log.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace seqSplotch
+{
+namespace
+{
+const char _magic[4] = { 'S', 'Q', 'P', 'F' };
+const uint32_t _version = 1;
+const size_t _headerSize = 16;
+
+bool _pread( const int fd, void* data, const size_t size, const size_t offset )
+{
+    char* ptr = static_cast< char* >( data );
+    size_t done = 0;
+    while( done < size )
+    {
+        const ssize_t result = ::pread( fd, ptr + done, size - done,
+                                        offset + done );
+        if( result <= 0 )
+        {
+            LBERROR << "Read error in particle file: "
+                    << ( result < 0 ? strerror( errno ) : "end of file" )
+                    << std::endl;
+            return false;
+        }
+        done += result;
+    }
+    return true;
+}
+}
+
+bool ParticleFile::isParticleFile( const servus::URI& uri )
+{
+    const std::string& path = uri.getPath();
+    return path.size() > 4 && path.compare( path.size() - 4, 4, ".sqp" ) == 0;
+}
+
+ParticleFile::ParticleFile( const std::string& filename, const float start,
+                            const float end )
+    : _fd( ::open( filename.c_str(), O_RDONLY ))
+    , _first( 0 )
+    , _numParticles( 0 )
+{
+    if( _fd < 0 )
+    {
+        LBERROR << "Can't open particle file " << filename << ": "
+                << strerror( errno ) << std::endl;
+        return;
+    }
+
+    char header[_headerSize];
+    struct stat info;
+    if( ::fstat( _fd, &info ) != 0 || size_t( info.st_size ) < _headerSize ||
+        !_pread( _fd, header, _headerSize, 0 ))
+    {
+        LBERROR << "Not a particle file: " << filename << std::endl;
+        ::close( _fd );
+        _fd = -1;
+        return;
+    }
+
+    uint32_t version = 0;
+    uint64_t numParticles = 0;
+    memcpy( &version, header + 4, sizeof( version ));
+    memcpy( &numParticles, header + 8, sizeof( numParticles ));
+    if( !std::equal( header, header + 4, _magic ) || version != _version )
+    {
+        LBERROR << "Not a particle file: " << filename << std::endl;
+        ::close( _fd );
+        _fd = -1;
+        return;
+    }
+    if( numParticles > ( size_t( info.st_size ) - _headerSize ) /
+                       sizeof( particle_sim ))
+    {
+        LBERROR << "Truncated particle file " << filename << ", "
+                << numParticles << " particles in the header" << std::endl;
+        ::close( _fd );
+        _fd = -1;
+        return;
+    }
+    _first = std::min( size_t( start * float( numParticles )),
+                       size_t( numParticles ));
+    const size_t last = end >= 1.f ? numParticles :
+                        std::max( _first, size_t( end * float( numParticles )));
+    _numParticles = last - _first;
+}
+
+ParticleFile::~ParticleFile()
+{
+    if( _fd >= 0 )
+        ::close( _fd );
+}
+
+bool ParticleFile::isValid() const
+{
+    return _fd >= 0;
+}
+
+size_t ParticleFile::getNumParticles() const
+{
+    return _numParticles;
+}
+
+bool ParticleFile::read( const size_t offset, const size_t count,
+                         Particles& particles ) const
+{
+    const size_t begin = std::min( offset, _numParticles );
+    FramePool::allocate( particles, std::min( count, _numParticles - begin ));
+    if( particles.empty( ))
+        return true;
+    if( _pread( _fd, particles.data(),
+                particles.size() * sizeof( particle_sim ),
+                _headerSize + ( _first + begin ) * sizeof( particle_sim )))
+    {
+        return true;
+    }
+    particles.clear();
+    return false;
+}
+
+bool ParticleFile::readSubset( const size_t maxParticles,
+                               Particles& particles ) const
+{
+    const size_t stride = std::max( size_t( 1 ),
+                              ( _numParticles + maxParticles - 1 ) /
+                              std::max( maxParticles, size_t( 1 )));
+    if( stride == 1 )
+        return read( 0, _numParticles, particles );
+
+    // one sequential pass, strided reads of single records are far slower
+    particles.clear();
+    particles.reserve( _numParticles / stride + 1 );
+    const size_t blockSize = stride * 65536;
+    Particles block;
+    for( size_t offset = 0; offset < _numParticles; offset += blockSize )
+    {
+        if( !read( offset, blockSize, block ))
+        {
+            particles.clear();
+            return false;
+        }
+        for( size_t i = 0; i < block.size(); i += stride )
+            particles.push_back( block[i] );
+    }
+    return true;
+}
+
+bool ParticleFile::write( const std::string& filename,
+                          const Particles& particles )
+{
+    std::ofstream file( filename.c_str(), std::ios::binary );
+    const uint64_t numParticles = particles.size();
+    file.write( _magic, sizeof( _magic ));
+    file.write( reinterpret_cast< const char* >( &_version ),
+                sizeof( _version ));
+    file.write( reinterpret_cast< const char* >( &numParticles ),
+                sizeof( numParticles ));
+    file.write( reinterpret_cast< const char* >( particles.data( )),
+                particles.size() * sizeof( particle_sim ));
+    if( !file )
+    {
+        LBERROR << "Can't write particle file " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,92 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_PARTICLEFILE_H
+#define SEQ_SPLOTCH_PARTICLEFILE_H
+
+#include <servus/uri.h>
+#include <splotch/splotchutils.h>
+
+namespace seqSplotch
+{
+
+/**
+ * A single frame stored as raw particle_sim records, read in batches.
+ *
+ * The file is a 16 byte header (magic "SQPF", uint32 version, uint64 number
+ * of particles) followed by the particles in native byte order. Reads use
+ * pread, so batches can be read from several threads.
+ */
+class ParticleFile
+{
+public:
+    typedef std::vector< particle_sim > Particles;
+
+    /** @return true if the URI names a particle file (*.sqp). */
+    static bool isParticleFile( const servus::URI& uri );
+
+    /**
+     * Open the given fraction of the particles of a file, all reads are
+     * relative to the start of the range. The range is empty if the file
+     * can't be opened.
+     */
+    explicit ParticleFile( const std::string& filename, float start = 0.f,
+                           float end = 1.f );
+    ~ParticleFile();
+
+    /** @return false if the file can't be opened or is not a particle file. */
+    bool isValid() const;
+
+    /** @return the number of particles in the range. */
+    size_t getNumParticles() const;
+
+    /**
+     * Read up to count particles starting at the given particle.
+     * @return false on a read error, particles is empty then.
+     */
+    bool read( size_t offset, size_t count, Particles& particles ) const;
+
+    /**
+     * Read an evenly spaced subset of at most maxParticles particles.
+     * @return false on a read error.
+     */
+    bool readSubset( size_t maxParticles, Particles& particles ) const;
+
+    /** @return false if the file could not be written. */
+    static bool write( const std::string& filename,
+                       const Particles& particles );
+
+private:
+    int _fd;
+    size_t _first;
+    size_t _numParticles;
+};
+
+}
+
+#endif
@@ -28,7 +28,11 @@
 
 #include "renderer.h"
 
+#include "cores.h"
+#include "kernels.h"
 #include "model.h"
+#include "stats.h"
+#include "tracer.h"
 #include "viewData.h"
 
 #ifdef CUDA
@@ -46,8 +50,17 @@
 #  include "osprayRenderer.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+
 namespace seqSplotch
 {
+namespace
+{
+std::atomic< size_t > _numRenderers( 0 );
+std::atomic< bool > _splotchRangeRejected( false );
+}
 
 Renderer::Renderer( seq::Application& app )
     : seq::Renderer( app )
@@ -60,19 +73,49 @@ Renderer::Renderer( seq::Application& app )
     , _colorSSBO( 0 )
     , _indices( 0 )
     , _rectVBO( 0 )
-    , _gpuModelFrameIndex( std::numeric_limits< size_t >::max( ))
-    , _osprayModelFrameIndex( std::numeric_limits< size_t >::max( ))
+    , _gpuModel( nullptr )
+    , _gpuModelRevision( std::numeric_limits< size_t >::max( ))
+    , _gpuHiddenTypes( 0 )
+    , _osprayModel( nullptr )
+    , _osprayModelRevision( std::numeric_limits< size_t >::max( ))
+    , _osprayHiddenTypes( 0 )
     , _numParticles( 0 )
-{}
+    , _frameNumber( 0 )
+    , _moving( false )
+    , _frameTime( 0.f )
+    , _frameParticles( 0 )
+    , _frameChannels( 1 )
+    , _drawnParticles( 0 )
+    , _culledParticles( 0 )
+    , _level( 0 )
+    , _resolution( 1.f )
+    , _colorizedModel( nullptr )
+    , _colorizedRevision( std::numeric_limits< size_t >::max( ))
+    , _colorizedLevel( 0 )
+    , _colorizedHiddenTypes( 0 )
+    , _index( _numRenderers++ )
+    , _coresPartitioned( false )
+{
+    addCoreShare( this );
+}
+
+Renderer::~Renderer()
+{
+    removeCoreShare( this );
+}
 
 bool Renderer::init( co::Object* initData )
 {
     if( !seq::Renderer::init( initData ))
         return false;
 
+    if( initData )
+        _modelURI = static_cast< const InitData* >( initData )->getUriString();
+
     if( !GLEW_VERSION_4_3 )
     {
         LBINFO << "GPU renderer not enabled, requires OpenGL 4.3" << std::endl;
+        static_cast< Application& >( getApplication( )).setGPUUnavailable();
         return true;
     }
 
@@ -97,10 +140,87 @@ bool Renderer::exit()
     om.deleteBuffer( &_colorSSBO );
     om.deleteBuffer( &_indices );
     om.deleteBuffer( &_rectVBO );
+    _models.clear();
 
     return seq::Renderer::exit();
 }
 
+Model& Renderer::_getModel()
+{
+    // A DB range draws the particles of this range of the data, whoever
+    // renders it, so all renderers of a compound agree on the partition.
+    Application& application = static_cast< Application& >( getApplication( ));
+    const eq::Range& range = getRenderContext().range;
+    if( application.hasModel() && range == eq::Range::ALL )
+        return application.getModel();
+
+    // on the master, only the channels of a DB compound load their range
+    const std::pair< size_t, size_t > parts = _getParts();
+    for( RangeModel& rangeModel : _models )
+    {
+        if( rangeModel.first == parts.first && rangeModel.last == parts.second )
+        {
+            rangeModel.frame = _frameNumber;
+            return *rangeModel.model;
+        }
+    }
+    _models.push_back( RangeModel{ parts.first, parts.second,
+                                   application.getRangeModel( _modelURI,
+                                                              parts.first,
+                                                              parts.second ),
+                                   _frameNumber });
+    return *_models.back().model;
+}
+
+std::pair< size_t, size_t > Renderer::_getParts() const
+{
+    // The load equalizer moves the ranges a little every frame. Rounded to
+    // a fixed partition they map to few models, and adjacent channels agree
+    // on their common boundary.
+    const eq::Range& range = getRenderContext().range;
+    const float numParts = float( Application::getNumParts( ));
+    return std::make_pair( size_t( std::lround( range.start * numParts )),
+                           size_t( std::lround( range.end * numParts )));
+}
+
+void Renderer::_releaseModels()
+{
+    // free the models of ranges not drawn in the last frame, the load
+    // equalizer has moved on
+    Application& application = static_cast< Application& >( getApplication( ));
+    for( auto i = _models.begin(); i != _models.end( ); )
+    {
+        if( i->frame + 1 >= _frameNumber )
+        {
+            ++i;
+            continue;
+        }
+
+        const Model* model = i->model.get();
+        if( _gpuModel == model )
+            _gpuModel = nullptr;
+        if( _osprayModel == model )
+            _osprayModel = nullptr;
+        if( _colorizedModel == model )
+            _colorizedModel = nullptr;
+        application.releaseRangeModel( i->model );
+        i = _models.erase( i );
+    }
+}
+
+bool Renderer::_isLocalModel( const Model& model ) const
+{
+    return std::any_of( _models.begin(), _models.end(),
+                        [&model]( const RangeModel& candidate )
+                        { return candidate.model.get() == &model; });
+}
+
+uint32_t Renderer::_getHiddenTypes() const
+{
+    const ViewData* viewData = static_cast< const ViewData* >( getViewData( ));
+    return viewData ? viewData->getHiddenTypes() : 0;
+}
+
 bool Renderer::_loadShaders()
 {
     seq::ObjectManager& om = getObjectManager();
@@ -169,36 +289,32 @@ bool Renderer::_createBuffers()
 void Renderer::_updateGPUBuffers()
 {
     Application& application = static_cast< Application& >( getApplication( ));
-    Model& model = application.getModel();
-    if( _gpuModelFrameIndex == model.getFrameIndex( ))
+    Model& model = _getModel();
+    const uint32_t hiddenTypes = _getHiddenTypes();
+    if( _gpuModel == &model && _gpuModelRevision == model.getRevision() &&
+        _gpuHiddenTypes == hiddenTypes )
+    {
         return;
+    }
 
-    _gpuModelFrameIndex = model.getFrameIndex();
-
-    const auto& allParticles = model.getParticles();
-
-    std::vector< particle_sim >  filteredParticles;
-    filteredParticles.reserve( allParticles.size( ));
+    _gpuModel = &model;
+    _gpuModelRevision = model.getRevision();
+    _gpuHiddenTypes = hiddenTypes;
 
-    // Generate colour in same way splotch does (Add brightness here):
-    for( size_t i = 0; i < allParticles.size(); ++i )
+    std::vector< particle_sim > filteredParticles;
     {
-        const auto& particle = allParticles[i];
-        if( particle.r <= std::numeric_limits< float >::epsilon( ))
-            continue;
-
-        filteredParticles.push_back( particle );
-        auto& newParticle = *filteredParticles.rbegin();
-        if (!model.getColourIsVec()[particle.type])
-            newParticle.e = model.getColorMaps()[particle.type].getVal_const(particle.e.r) * particle.I;
-        else
-            newParticle.e *= particle.I;
+        Stats::Timer timer( &application.getStats(), _channelName,
+                            Stats::STAGE_COLORIZE );
+        colorizeParticles( model, filteredParticles, _numLevelParticles,
+                           hiddenTypes );
     }
 
     _numParticles = filteredParticles.size();
     if( _numParticles == 0 )
         return;
 
+    Stats::Timer timer( &application.getStats(), _channelName,
+                        Stats::STAGE_UPLOAD );
     EQ_GL_CALL( glBindBuffer( GL_SHADER_STORAGE_BUFFER, _posSSBO ));
     EQ_GL_CALL( glBufferData( GL_SHADER_STORAGE_BUFFER,
                               sizeof(seq::Vector4f) * _numParticles, 0, GL_STATIC_DRAW ));
@@ -209,17 +325,8 @@ void Renderer::_updateGPUBuffers()
                               sizeof(seq::Vector4f) * _numParticles, 0, GL_STATIC_DRAW ));
     EQ_GL_CALL( glBindBuffer( GL_SHADER_STORAGE_BUFFER, 0 ));
 
-    std::vector< uint32_t > indices( _numParticles * 6 );
-    for (size_t i = 0, j = 0; i < _numParticles; ++i)
-    {
-        size_t index = i << 2;
-        indices[j++] = index;
-        indices[j++] = index + 1;
-        indices[j++] = index + 2;
-        indices[j++] = index;
-        indices[j++] = index + 2;
-        indices[j++] = index + 3;
-    }
+    std::vector< uint32_t > indices;
+    fillQuadIndices( _numParticles, indices );
 
     EQ_GL_CALL( glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indices ));
     EQ_GL_CALL( glBufferData( GL_ELEMENT_ARRAY_BUFFER,
@@ -232,11 +339,7 @@ void Renderer::_updateGPUBuffers()
     EQ_GL_CALL( glBindBuffer( GL_SHADER_STORAGE_BUFFER, _colorSSBO ));
     seq::Vector4f* color = reinterpret_cast< seq::Vector4f* >( glMapBuffer( GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY ));
 
-    for( size_t i = 0; i < _numParticles; ++i )
-    {
-        pos[i] = seq::Vector4f( filteredParticles[i].x, filteredParticles[i].y, filteredParticles[i].z, 1.0f );
-        color[i] = seq::Vector4f( filteredParticles[i].e.r, filteredParticles[i].e.g, filteredParticles[i].e.b, 1.0f );
-    }
+    fillParticleBuffers( filteredParticles, pos, color );
 
     EQ_GL_CALL( glBindBuffer( GL_SHADER_STORAGE_BUFFER, _posSSBO ));
     EQ_GL_CALL( glUnmapBuffer( GL_SHADER_STORAGE_BUFFER ));
@@ -267,6 +370,9 @@ void Renderer::_drawBlurPass( eq::util::FrameBufferObject* targetFBO,
 
 void Renderer::_blit( eq::util::FrameBufferObject* fbo )
 {
+    Application& application = static_cast< Application& >( getApplication( ));
+    Stats::Timer timer( &application.getStats(), _channelName,
+                        Stats::STAGE_BLIT );
     const eq::PixelViewport& pvp = getPixelViewport();
     fbo->bind( GL_READ_FRAMEBUFFER_EXT );
     bindDrawFrameBuffer();
@@ -276,105 +382,414 @@ void Renderer::_blit( eq::util::FrameBufferObject* fbo )
     fbo->unbind();
 }
 
-void Renderer::_splotchRender()
+#ifndef CUDA
+const Model::Particles& Renderer::_getColorizedParticles()
 {
+    // Colours do not depend on the eye, compute them once per model frame,
+    // pipe and range
+    Model& model = _getModel();
+    const uint32_t hiddenTypes = _getHiddenTypes();
+    if( _colorizedModel == &model &&
+        _colorizedRevision == model.getRevision() &&
+        _colorizedLevel == _level && _colorizedHiddenTypes == hiddenTypes )
+    {
+        return _colorizedParticles;
+    }
+    _colorizedModel = &model;
+    _colorizedRevision = model.getRevision();
+    _colorizedLevel = _level;
+    _colorizedHiddenTypes = hiddenTypes;
+
     Application& application = static_cast< Application& >( getApplication( ));
-    Model& model = application.getModel();
-    auto particles = model.getParticles();
-    if( particles.empty( ))
+    Stats::Timer timer( &application.getStats(), _channelName,
+                        Stats::STAGE_COLORIZE );
+    gatherParticles( model.getParticles(),
+                     model.getVisibleRanges( hiddenTypes, _level ),
+                     _colorizedParticles );
+    colorParticles( model.getParams(), _colorizedParticles,
+                    model.getColorMaps(), model.getBrightness( _level ));
+    return _colorizedParticles;
+}
+
+void Renderer::_splatColorized( arr2< COLOUR >& pic,
+                                arr2< COLOUR >* otherPic,
+                                const seq::Vector3f& origin,
+                                const seq::Vector3f& lookAt,
+                                const seq::Vector3f& up, const float eyeOffset,
+                                const seq::Vector2i& offset )
+{
+    paramfile& params = _getModel().getParams();
+    const Model::Particles& particles = _getColorizedParticles();
+    const vec3 center( origin.x(), origin.y(), origin.z( ));
+    const vec3 target( lookAt.x(), lookAt.y(), lookAt.z( ));
+    const vec3 sky( up.x(), up.y(), up.z( ));
+    if( !otherPic )
+    {
+        splatParticles( params, particles, pic, center, target, sky,
+                        eyeOffset, offset, _renderParticles );
+        _frameParticles += particles.size();
+        _countParticles( _renderParticles );
         return;
+    }
+
+    // pic is the eye at eyeOffset, otherPic the other eye of the pair
+    const bool isLeft = eyeOffset <= 0.f;
+    splatStereo( params, particles, isLeft ? pic : *otherPic,
+                 isLeft ? *otherPic : pic, center, target, sky,
+                 std::abs( eyeOffset ), offset,
+                 isLeft ? _renderParticles : _otherEyeParticles,
+                 isLeft ? _otherEyeParticles : _renderParticles );
+    _frameParticles += 2 * particles.size();
+    _countParticles( _renderParticles );
+}
+#endif
+
+void Renderer::_renderSplotchImage( const seq::Vector2i& size,
+                                    const eq::PixelViewport& region,
+                                    std::vector< float >& pixels,
+                                    std::vector< float >* otherPixels )
+{
+    Application& application = static_cast< Application& >( getApplication( ));
+    Model& model = _getModel();
 
     seq::Vector3f origin, lookAt, up;
     seq::Matrix4f modelViewMatrix = getViewMatrix() * getModelMatrix();
     modelViewMatrix( 3, 2 ) = -modelViewMatrix( 3, 2 );
     modelViewMatrix.getLookAt( origin, lookAt, up );
     seq::Vector3f eye = origin;
+    float eyeOffset = 0.f; // along the right axis of the camera
+    const ViewData* viewData = static_cast< const ViewData* >( getViewData( ));
     if( getRenderContext().eye != eq::EYE_CYCLOP )
     {
         const seq::Vector3f view = lookAt - origin;
         const seq::Vector3f right = vmml::cross( view, up );
 
-        const ViewData* viewData = static_cast< const ViewData* >( getViewData( ));
         const float dist2 = viewData->getEyeSeparation() * view.length() * .5f;
 
         switch( getRenderContext().eye )
         {
         case eq::EYE_LEFT:
-            eye = origin - right / right.length()  * dist2;
+            eyeOffset = -dist2;
             break;
         case eq::EYE_RIGHT:
-            eye = origin + right / right.length()  * dist2;
+            eyeOffset = dist2;
             break;
         default:
             ;
         }
+        eye = origin + right / right.length() * eyeOffset;
     }
 
     paramfile& params = model.getParams();
-    const eq::PixelViewport& pvp = getPixelViewport();
-    const int width = pvp.w;
-    const int height = pvp.h;
-    arr2< COLOUR > pic( width, height );
+    const int width = size.x();
+    const int height = size.y();
+    params.setParam( "xres", width );
+    params.setParam( "yres", height );
+    const bool isCropped = region.x != 0 || region.y != 0 ||
+                           region.w != width || region.h != height;
+    arr2< COLOUR > pic( region.w, region.h );
+    arr2< COLOUR > otherPic( otherPixels ? region.w : 0,
+                             otherPixels ? region.h : 0 );
+    {
+        Stats::Timer timer( &application.getStats(), _channelName,
+                            Stats::STAGE_RENDER );
 #ifdef CUDA
-    cuda_rendering( 0, 1, pic, particles,
-                    vec3( eye.x(), eye.y(), eye.z()),
-                    vec3( origin.x(), origin.y(), origin.z()),
-                    vec3( lookAt.x(), lookAt.y(), lookAt.z()),
-                    vec3( up.x(), up.y(), up.z()),
-                    model.amap, model.b_brightness, params );
+        Model::Particles particles;
+        gatherParticles( model.getParticles(),
+                         model.getVisibleRanges( _getHiddenTypes(), _level ),
+                         particles );
+        _frameParticles += particles.size();
+        _drawnParticles += particles.size();
+        cuda_rendering( 0, 1, pic, particles,
+                        vec3( eye.x(), eye.y(), eye.z()),
+                        vec3( origin.x(), origin.y(), origin.z()),
+                        vec3( lookAt.x(), lookAt.y(), lookAt.z()),
+                        vec3( up.x(), up.y(), up.z()),
+                        model.amap, model.b_brightness, params );
 #else
-    host_rendering( params, particles, pic,
-                    vec3( eye.x(), eye.y(), eye.z()),
-                    vec3( origin.x(), origin.y(), origin.z()),
-                    vec3( lookAt.x(), lookAt.y(), lookAt.z()),
-                    vec3( up.x(), up.y(), up.z()),
-                    model.getColorMaps(), model.getBrightness(), particles.size( ));
+        // Frames larger than memory are streamed from their file. The new
+        // renderer colourises once per frame. A stereo pair is projected
+        // and sorted once for both eyes, a cropped region is projected into
+        // it. The old renderer always runs host_rendering on the full image.
+        if( model.getParticleFile( ))
+        {
+            const size_t numParticles = splatParticleFile(
+                *model.getParticleFile(), params, pic,
+                vec3( eye.x(), eye.y(), eye.z()),
+                vec3( lookAt.x(), lookAt.y(), lookAt.z()),
+                vec3( up.x(), up.y(), up.z()), model.getColorMaps( ));
+            _frameParticles += numParticles;
+            _drawnParticles += numParticles;
+        }
+        else if( otherPixels || isCropped )
+        {
+            _splatColorized( pic, otherPixels ? &otherPic : nullptr, origin,
+                             lookAt, up, eyeOffset,
+                             seq::Vector2i( region.x, region.y ));
+        }
+        else
+        {
+            // Splotch projects in place. The copy is split like the
+            // projection, each OpenMP thread then reads its local pages.
+            // Hidden types are skipped without looking at their particles.
+            gatherParticles( model.getParticles(),
+                             model.getVisibleRanges( _getHiddenTypes(),
+                                                     _level ),
+                             _renderParticles );
+            Model::Particles& particles = _renderParticles;
+            _frameParticles += particles.size();
+            host_rendering( params, particles, pic,
+                            vec3( eye.x(), eye.y(), eye.z()),
+                            vec3( origin.x(), origin.y(), origin.z()),
+                            vec3( lookAt.x(), lookAt.y(), lookAt.z()),
+                            vec3( up.x(), up.y(), up.z()),
+                            model.getColorMaps(), model.getBrightness( _level ),
+                            particles.size( ));
+            _countParticles( particles );
+        }
 #endif
+    }
 
-    const bool a_eq_e = params.find<bool>("a_eq_e",true);
-    if( a_eq_e )
+    Stats::Timer timer( &application.getStats(), _channelName,
+                        Stats::STAGE_POSTPROCESS );
+    toneMap( pic, params );
+    transposeImage( pic, pixels );
+    if( otherPixels )
     {
-        exptable<float32> xexp(-20.0);
+        toneMap( otherPic, params );
+        transposeImage( otherPic, *otherPixels );
+    }
+}
+
+void Renderer::_drawPixels( const std::vector< float >& pixels,
+                            const seq::Vector2i& imageSize,
+                            const seq::Vector2i& size,
+                            const seq::Vector2i& offset )
+{
+    Application& application = static_cast< Application& >( getApplication( ));
+    Stats::Timer timer( &application.getStats(), _channelName,
+                        Stats::STAGE_BLIT );
+    const eq::PixelViewport& pvp = getPixelViewport();
+    EQ_GL_CALL( glWindowPos2i( pvp.x, pvp.y ));
+    _setPixelZoom( size );
+    EQ_GL_CALL( glPixelStorei( GL_UNPACK_ROW_LENGTH, imageSize.x( )));
+    EQ_GL_CALL( glPixelStorei( GL_UNPACK_SKIP_PIXELS, offset.x( )));
+    EQ_GL_CALL( glPixelStorei( GL_UNPACK_SKIP_ROWS, offset.y( )));
+    EQ_GL_CALL( glDrawPixels( size.x(), size.y(), GL_RGB, GL_FLOAT,
+                              pixels.data( )));
+    EQ_GL_CALL( glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 ));
+    EQ_GL_CALL( glPixelStorei( GL_UNPACK_SKIP_PIXELS, 0 ));
+    EQ_GL_CALL( glPixelStorei( GL_UNPACK_SKIP_ROWS, 0 ));
+    EQ_GL_CALL( glPixelZoom( 1.f, 1.f ));
+}
+
+bool Renderer::_canReproject( const SplotchImage& image,
+                              const seq::Matrix4f& modelView )
+{
+    const ViewData* viewData = static_cast< const ViewData* >( getViewData( ));
+    Model& model = _getModel();
+    if( !viewData->getReprojection() || !_moving || image.pixels.empty() ||
+        image.modelRevision != model.getRevision() || image.level != _level ||
+        image.hiddenTypes != _getHiddenTypes() ||
+        image.region != eq::PixelViewport( 0, 0, image.size.x(),
+                                           image.size.y( )))
+    {
+        return false;
+    }
+
+    // camera motion since the reference image: rotation angle plus translation
+    // relative to the model size
+    seq::Matrix4f inverse;
+    if( !modelView.inverse( inverse ))
+        return false;
+    const seq::Matrix4f delta = image.modelView * inverse;
+    const float trace = delta( 0, 0 ) + delta( 1, 1 ) + delta( 2, 2 );
+    const float angle = std::acos( std::max( -1.f, std::min( 1.f,
+                                                 ( trace - 1.f ) * .5f )));
+    const seq::Vector3f translation( delta( 0, 3 ), delta( 1, 3 ),
+                                     delta( 2, 3 ));
+    const float size = std::max( model.getBoundingSphere().w(),
+                                 std::numeric_limits< float >::epsilon( ));
+    const float threshold = model.getParams().find< float >(
+                                "reprojection_threshold", .1f );
+    return angle + translation.length() / size < threshold;
+}
+
+void Renderer::_reproject( SplotchImage& image,
+                           const seq::Matrix4f& modelView )
+{
+    // Warp the reference image assuming all particles lie on a plane through
+    // the model center, facing the reference camera.
+    Model& model = _getModel();
+
+    seq::Matrix4f inverse;
+    modelView.inverse( inverse );
+    const seq::Matrix4f delta = image.modelView * inverse;
+
+    const seq::Vector4f& sphere = model.getBoundingSphere();
+    const seq::Vector4f center = image.modelView *
+                      seq::Vector4f( sphere.x(), sphere.y(), sphere.z(), 1.f );
+    const float depth = std::max( -center.z(), sphere.w() * .01f );
+
+    const int width = image.size.x();
+    const int height = image.size.y();
+    const float fov = model.getParams().find< float >( "fov", 45.f );
+    const float tanX = std::tan( fov * float( M_PI ) / 360.f );
+    const float tanY = tanX * float( height ) / float( width );
+    const seq::Vector3f origin( delta( 0, 3 ), delta( 1, 3 ), delta( 2, 3 ));
+
+    image.warped.resize( image.pixels.size( ));
 #pragma omp parallel for
-        for( int ix = 0; ix < width; ++ix )
+    for( int y = 0; y < height; ++y )
+    {
+        const float ny = ( float( y ) + .5f ) / float( height ) * 2.f - 1.f;
+        for( int x = 0; x < width; ++x )
         {
-            for( int iy = 0; iy < height; ++iy )
-            {
-                pic[ix][iy].r = -xexp.expm1(pic[ix][iy].r);
-                pic[ix][iy].g = -xexp.expm1(pic[ix][iy].g);
-                pic[ix][iy].b = -xexp.expm1(pic[ix][iy].b);
-            }
+            float* pixel = &image.warped[( y * width + x ) * 3];
+            pixel[0] = pixel[1] = pixel[2] = 0.f;
+
+            const float nx = ( float( x ) + .5f ) / float( width ) * 2.f - 1.f;
+            const seq::Vector3f ray( nx * tanX, ny * tanY, -1.f );
+            seq::Vector3f dir;
+            for( size_t i = 0; i < 3; ++i )
+                dir[i] = delta( i, 0 ) * ray[0] + delta( i, 1 ) * ray[1] +
+                         delta( i, 2 ) * ray[2];
+            if( std::abs( dir.z( )) <= std::numeric_limits< float >::epsilon( ))
+                continue;
+
+            const float t = ( -depth - origin.z( )) / dir.z();
+            const seq::Vector3f hit = origin + dir * t;
+            if( t <= 0.f || hit.z() >= 0.f )
+                continue;
+
+            const int sx = int(( hit.x() / ( -hit.z() * tanX ) * .5f + .5f ) *
+                               float( width ));
+            const int sy = int(( hit.y() / ( -hit.z() * tanY ) * .5f + .5f ) *
+                               float( height ));
+            if( sx < 0 || sx >= width || sy < 0 || sy >= height )
+                continue;
+            memcpy( pixel, &image.pixels[( sy * width + sx ) * 3],
+                    3 * sizeof( float ));
         }
     }
+}
 
-    const double gamma = params.find< double >("pic_gamma", 1.0 );
-    const double brightness = params.find< double >("pic_brighness", 0.0 );
-    const double contrast = params.find< double >("pic_contrast", 1.0 );
+void Renderer::_splotchRender()
+{
+    Model& model = _getModel();
+    if( model.getParticles().empty( ))
+        return;
 
-    if( gamma != 1.0 || brightness != 0.0 || contrast != 1.0 )
+    // With batch_channels, the Splotch camera covers the whole view: render
+    // it once per pipe frame, eye and range, and let each channel draw its
+    // part of it. Only the union of the channels drawn by this pipe is
+    // rendered.
+    const seq::RenderContext& context = getRenderContext();
+    const seq::Vector2i& size = _getRenderSize();
+    const bool batch = model.getParams().find< bool >( "batch_channels",
+                                                       false );
+    const seq::Vector2i imageSize = batch ? seq::Vector2i(
+        std::max( 1, int( float( size.x( )) / context.vp.w + .5f )),
+        std::max( 1, int( float( size.y( )) / context.vp.h + .5f ))) : size;
+    const eq::PixelViewport pvp = batch ? eq::PixelViewport()
+                                        : getPixelViewport();
+    const ViewData* viewData = static_cast< const ViewData* >( getViewData( ));
+    const bool isNew = viewData->getRenderer() ==
+                       serializable::RendererType::SPLOTCH_NEW;
+    eq::PixelViewport area( 0, 0, imageSize.x(), imageSize.y( ));
+#ifndef CUDA
+    if( batch && isNew && !model.getParticleFile( ))
     {
-#pragma omp parallel for
-        for( tsize i = 0; i < pic.size1(); ++i )
+        area.x = std::max( 0, std::min( int( context.vp.x * imageSize.x( )),
+                                        imageSize.x() - size.x( )));
+        area.y = std::max( 0, std::min( int( context.vp.y * imageSize.y( )),
+                                        imageSize.y() - size.y( )));
+        area.w = std::min( size.x(), imageSize.x( ));
+        area.h = std::min( size.y(), imageSize.y( ));
+    }
+#endif
+
+    // The new renderer draws both eyes of a stereo pair at once, the image
+    // of the other eye is ready when its channel is drawn.
+    bool isPair = false;
+#ifndef CUDA
+    isPair = isNew && context.eye != eq::EYE_CYCLOP &&
+             !model.getParticleFile();
+#endif
+    const eq::Eye otherEye = context.eye == eq::EYE_LEFT ? eq::EYE_RIGHT
+                                                         : eq::EYE_LEFT;
+    if( isPair )
+        _getImage( pvp, otherEye );
+    SplotchImage* image = &_getImage( pvp, context.eye );
+
+    // a channel outside of the rendered region grows it, at most once per
+    // channel as the region is kept across frames
+    eq::PixelViewport region = area;
+    if( image->size == imageSize && image->region.hasArea( ))
+        region.merge( image->region );
+    if( region != image->region )
+        image->frame = std::numeric_limits< uint64_t >::max();
+
+    if( image->frame != _frameNumber )
+    {
+        const seq::Matrix4f modelView = getViewMatrix() * getModelMatrix();
+        image->frame = _frameNumber;
+        if( image->size == imageSize && region == image->region &&
+            _canReproject( *image, modelView ))
+        {
+            _reproject( *image, modelView );
+            requestRedraw(); // render fully when the camera stops
+        }
+        else
         {
-            for( tsize j = 0; j < pic.size2(); ++j )
+            SplotchImage* other = isPair ? &_getImage( pvp, otherEye )
+                                         : nullptr;
+            for( SplotchImage* rendered : { image, other })
             {
-                pic[i][j].r = contrast * pow((double)pic[i][j].r,gamma) + brightness;
-                pic[i][j].g = contrast * pow((double)pic[i][j].g,gamma) + brightness;
-                pic[i][j].b = contrast * pow((double)pic[i][j].b,gamma) + brightness;
+                if( !rendered )
+                    continue;
+                rendered->frame = _frameNumber;
+                rendered->size = imageSize;
+                rendered->region = region;
+                rendered->modelView = modelView;
+                rendered->modelRevision = model.getRevision();
+                rendered->hiddenTypes = _getHiddenTypes();
+                rendered->level = _level;
+                rendered->warped.clear();
             }
-       }
+            _renderSplotchImage( imageSize, region, image->pixels,
+                                 other ? &other->pixels : nullptr );
+        }
     }
 
-    _pixels.grow( width * height * 3 );
-    int k = 0;
-    for( int j = 0; j < height; ++j )
+    const seq::Vector2i offset( area.x - image->region.x,
+                                area.y - image->region.y );
+    _drawPixels( image->warped.empty() ? image->pixels : image->warped,
+                 seq::Vector2i( image->region.w, image->region.h ), size,
+                 offset );
+}
+
+Renderer::SplotchImage& Renderer::_getImage( const eq::PixelViewport& pvp,
+                                             const eq::Eye eye )
+{
+    const seq::RenderContext& context = getRenderContext();
+    for( SplotchImage& image : _images )
     {
-        for( int i = 0; i < width; ++i, k+=3 )
-            memcpy( &_pixels[k], &pic[i][j], 3 * sizeof( float ));
+        if( image.viewData == getViewData() && image.pvp == pvp &&
+            image.eye == eye && image.rangeStart == context.range.start )
+        {
+            return image;
+        }
     }
 
-    EQ_GL_CALL( glWindowPos2i( pvp.x, pvp.y ));
-    EQ_GL_CALL( glDrawPixels( width, height, GL_RGB, GL_FLOAT, _pixels.getData( )));
+    _images.push_back( SplotchImage( ));
+    SplotchImage& image = _images.back();
+    image.viewData = getViewData();
+    image.pvp = pvp;
+    image.eye = eye;
+    image.rangeStart = context.range.start;
+    image.frame = std::numeric_limits< uint64_t >::max();
+    return image;
 }
 
 void Renderer::_osprayRender()
@@ -384,11 +799,18 @@ void Renderer::_osprayRender()
         _osprayRenderer.reset( new OSPRayRenderer );
 
     Application& application = static_cast< Application& >( getApplication( ));
-    Model& model = application.getModel();
-    if( _osprayModelFrameIndex != model.getFrameIndex( ))
+    Model& model = _getModel();
+    const uint32_t hiddenTypes = _getHiddenTypes();
+    if( _osprayModel != &model ||
+        _osprayModelRevision != model.getRevision() ||
+        _osprayHiddenTypes != hiddenTypes )
     {
-        _osprayModelFrameIndex = model.getFrameIndex();
-        _osprayRenderer->update( model );
+        Stats::Timer timer( &application.getStats(), _channelName,
+                            Stats::STAGE_OSPRAY_BUILD );
+        _osprayModel = &model;
+        _osprayModelRevision = model.getRevision();
+        _osprayHiddenTypes = hiddenTypes;
+        _osprayRenderer->update( model, hiddenTypes );
     }
 
     const eq::PixelViewport& pvp = getPixelViewport();
@@ -396,9 +818,14 @@ void Renderer::_osprayRender()
 
     _osprayRenderer->updateCamera( viewData->getCamera( ));
 
+    const seq::Vector2i& size = _getRenderSize();
     EQ_GL_CALL( glWindowPos2i( pvp.x, pvp.y ));
-    if( _osprayRenderer->render( seq::Vector2i( pvp.w, pvp.h ), getModelMatrix(), viewData->getFOV()[1]))
+    _setPixelZoom( size );
+    Stats::Timer timer( &application.getStats(), _channelName,
+                        Stats::STAGE_OSPRAY_RENDER );
+    if( _osprayRenderer->render( size, getModelMatrix(), viewData->getFOV()[1]))
         requestRedraw();
+    EQ_GL_CALL( glPixelZoom( 1.f, 1.f ));
 #endif
 }
 
@@ -411,12 +838,18 @@ void Renderer::_gpuRender()
     if( _numParticles == 0 )
         return;
 
+    Application& application = static_cast< Application& >( getApplication( ));
+    const Model& model = _getModel();
+    const size_t numParticles = _numLevelParticles[_level];
+    _frameParticles += numParticles;
+    _drawnParticles += numParticles;
+
     const eq::PixelViewport& pvp = getPixelViewport();
     _fbo->resize( pvp.w, pvp.h );
     _fboBlur1->resize( pvp.w, pvp.h );
     _fboBlur2->resize( pvp.w, pvp.h );
 
-    float brightnessMod = 8.0;
+    float brightnessMod = 8.0 * model.getBrightness( _level );
     float saturation = 1.0;
     float contrast   = 1.0;
     float particleSize = 0.6;
@@ -437,6 +870,8 @@ void Renderer::_gpuRender()
     EQ_GL_CALL( glUniform1f( loc, nParticleSize ));
 
     {
+        Stats::Timer timer( &application.getStats(), _channelName,
+                            Stats::STAGE_RENDER );
         _fbo->bind();
 
         EQ_GL_CALL( glViewport( pvp.x, pvp.y, pvp.w, pvp.h ));
@@ -463,7 +898,7 @@ void Renderer::_gpuRender()
             EQ_GL_CALL( glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 1, _posSSBO ));
             EQ_GL_CALL( glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 2, _colorSSBO ));
             EQ_GL_CALL( glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _indices ));
-            EQ_GL_CALL( glDrawElements( GL_TRIANGLES, _numParticles * 6, GL_UNSIGNED_INT, 0 ));
+            EQ_GL_CALL( glDrawElements( GL_TRIANGLES, numParticles * 6, GL_UNSIGNED_INT, 0 ));
             EQ_GL_CALL( glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 ));
         }
 
@@ -526,15 +961,212 @@ void Renderer::destroyViewData( seq::ViewData* viewData )
     delete viewData;
 }
 
-void Renderer::draw( co::Object* /*frameDataObj*/ )
+std::string Renderer::_getChannelName() const
+{
+    // Channels are drawn in the same order every frame, whatever their
+    // viewport. Their place in the pipe frame names them for Stats.
+    const seq::RenderContext& context = getRenderContext();
+    const size_t channel = std::count( _drawnChannels.begin(),
+                                       _drawnChannels.end(), context.eye ) - 1;
+    std::ostringstream name;
+    name << "pipe" << _index << "/channel" << channel;
+    switch( context.eye )
+    {
+    case eq::EYE_LEFT:
+        name << "/left";
+        break;
+    case eq::EYE_RIGHT:
+        name << "/right";
+        break;
+    default:
+        break;
+    }
+    return name.str();
+}
+
+bool Renderer::_startChannel()
+{
+    // A pipe frame starts with a new frame ID. The master changes the frame
+    // data every frame, so this holds however the channels are decomposed.
+    const lunchbox::uint128_t& frameID = getRenderContext().frameID;
+    const bool newFrame = _drawnChannels.empty() || frameID != _frameID;
+    if( newFrame )
+    {
+        _frameChannels = std::max( _drawnChannels.size(), size_t( 1 ));
+        _drawnChannels.clear();
+        _frameID = frameID;
+        ++_frameNumber;
+    }
+    _drawnChannels.push_back( getRenderContext().eye );
+    return newFrame;
+}
+
+void Renderer::_updateFrameBudget()
+{
+    // Adapt once per frame for all channels of this pipe, based on the time
+    // the pipe spent drawing the previous frame.
+    const float frameTime = _frameTime;
+    const size_t frameParticles = _frameParticles;
+    _frameTime = 0.f;
+    _frameParticles = 0;
+
+    _moving = getModelMatrix() != _previousModelMatrix;
+    _previousModelMatrix = getModelMatrix();
+
+    if( !_moving )
+    {
+        // still image: refine to full detail
+        if( _level > 0 || _resolution < 1.f )
+            requestRedraw();
+        _level = 0;
+        _resolution = 1.f;
+        return;
+    }
+
+    if( frameTime <= 0.f )
+        return;
+
+    // One controller trades the level against the resolution, so the two do
+    // not correct the same frame time at once. Nothing changes within the
+    // tolerance around the target. Over it, the level coarsens first and the
+    // resolution drops only at the coarsest level. Under it, the resolution
+    // recovers first, then the level refines.
+    Model& model = _getModel();
+    paramfile& params = model.getParams();
+    _level = std::min( _level, model.getNumLevels() - 1 );
+    const float targetTime = params.find< float >( "target_frame_time", 40.f );
+    const float tolerance = params.find< float >( "frame_time_tolerance",
+                                                  .15f );
+    if( frameTime > targetTime * ( 1.f + tolerance ))
+    {
+        if( !_selectLevel( frameTime, frameParticles, targetTime ))
+            _selectResolution( frameTime, targetTime );
+    }
+    else if( frameTime < targetTime * ( 1.f - tolerance ))
+    {
+        if( _resolution >= 1.f ||
+            !_selectResolution( frameTime, targetTime ))
+        {
+            _selectLevel( frameTime, frameParticles, targetTime );
+        }
+    }
+}
+
+bool Renderer::_selectLevel( const float frameTime,
+                             const size_t frameParticles,
+                             const float targetTime )
+{
+    if( frameParticles == 0 )
+        return false;
+
+    // the time and particles are summed over all channels and eyes of the
+    // pipe, each channel draws getNumParticles( level ) of its own
+    Model& model = _getModel();
+    const float costPerParticle = frameTime / float( frameParticles );
+    const size_t maxParticles = size_t( targetTime / costPerParticle ) /
+                                _frameChannels;
+
+    size_t level = _level;
+    while( level + 1 < model.getNumLevels() &&
+           model.getNumParticles( level ) > maxParticles )
+    {
+        ++level;
+    }
+    while( level > 0 && model.getNumParticles( level - 1 ) <= maxParticles )
+        --level;
+
+    const bool changed = level != _level;
+    _level = level;
+    return changed;
+}
+
+bool Renderer::_selectResolution( const float frameTime,
+                                  const float targetTime )
+{
+    const ViewData* viewData = static_cast< const ViewData* >( getViewData( ));
+    if( !viewData->getDynamicResolution( ))
+    {
+        _resolution = 1.f;
+        return false;
+    }
+
+    const float minResolution = _getModel().getParams().find< float >(
+                                    "min_resolution", .25f );
+
+    // Cost is proportional to the pixel count, i.e. the square of the scale.
+    // Damp the correction to avoid oscillating around the target.
+    const float correction = std::sqrt( targetTime / frameTime );
+    const float resolution = std::max( minResolution, std::min(
+                     _resolution * ( 1.f + .5f * ( correction - 1.f )), 1.f ));
+    const bool changed = resolution != _resolution;
+    _resolution = resolution;
+    return changed;
+}
+
+seq::Vector2i Renderer::_getRenderSize() const
+{
+    const eq::PixelViewport& pvp = getPixelViewport();
+    return seq::Vector2i( std::max( 1, int( pvp.w * _resolution )),
+                          std::max( 1, int( pvp.h * _resolution )));
+}
+
+void Renderer::_setPixelZoom( const seq::Vector2i& size ) const
+{
+    const eq::PixelViewport& pvp = getPixelViewport();
+    EQ_GL_CALL( glPixelZoom( float( pvp.w ) / float( size.x( )),
+                             float( pvp.h ) / float( size.y( ))));
+}
+
+void Renderer::draw( co::Object* frameDataObj )
 {
+    Tracer::Span span( "Renderer::draw" );
     const ViewData* viewData = static_cast< const ViewData* >( getViewData( ));
     Application& application = static_cast< Application& >( getApplication( ));
 
-    Model& model = application.getModel();
+    // a DB range rounded to no part of the data draws nothing
+    const std::pair< size_t, size_t > parts = _getParts();
+    if( parts.first == parts.second )
+        return;
+
+    Model& model = _getModel();
+    if( !_coresPartitioned )
+    {
+        // all pipes of the process exist once the first frame is drawn
+        paramfile& params = model.getParams();
+        const int numThreads = params.find< int >( "pipe_threads", 0 );
+        partitionCores( this, size_t( std::max( numThreads, 0 )),
+                        params.find< bool >( "pin_pipe_threads", true ));
+        _coresPartitioned = true;
+    }
+
+    if( _isLocalModel( model ) && frameDataObj )
+    {
+        // all nodes switch to the frame of the master in the same frame
+        application.updateRangeModel( model, *static_cast< const FrameData* >(
+                                                 frameDataObj ));
+    }
     updateNearFar( model.getBoundingSphere( ));
     applyRenderContext(); // set up OpenGL State
 
+    const bool newFrame = _startChannel();
+    _channelName = _getChannelName();
+    _drawnParticles = 0;
+    _culledParticles = 0;
+    Stats::Timer timer( &application.getStats(), _channelName,
+                        Stats::STAGE_FRAME );
+
+    if( newFrame )
+    {
+        _updateFrameBudget();
+        _releaseModels();
+
+        // drop the images of channels not drawn in the last frame
+        _images.erase( std::remove_if( _images.begin(), _images.end(),
+            [&]( const SplotchImage& image )
+            { return image.frame + 1 < _frameNumber; }), _images.end( ));
+    }
+    const float startTime = _clock.getTimef();
+
     switch( viewData->getRenderer( ))
     {
     case serializable::RendererType::GPU:
@@ -543,10 +1175,18 @@ void Renderer::draw( co::Object* /*frameDataObj*/ )
     case serializable::RendererType::SPLOTCH_OLD:
     case serializable::RendererType::SPLOTCH_NEW:
     {
-        const eq::PixelViewport& pvp = getPixelViewport();
+        // Splotch images are tone-mapped per range and have no depth, sort-
+        // last compositing can't add them up
+        if( getRenderContext().range != eq::Range::ALL )
+        {
+            if( !_splotchRangeRejected.exchange( true ))
+                LBERROR << "Splotch renderers can't be composited sort-last, "
+                        << "DB ranges are not drawn. Use the GPU or OSPRay "
+                        << "renderer for DB decompositions" << std::endl;
+            break;
+        }
+
         paramfile& params = model.getParams();
-        params.setParam( "xres", pvp.w );
-        params.setParam( "yres", pvp.h );
         params.setParam( "fov", int(viewData->getFOV()[0] ));
         params.setParam( "new_renderer",
                          viewData->getRenderer() == serializable::RendererType::SPLOTCH_NEW );
@@ -562,6 +1202,28 @@ void Renderer::draw( co::Object* /*frameDataObj*/ )
         std::cerr << "Unknown renderer " << int(viewData->getRenderer( )) << std::endl;
         break;
     }
+
+    // Include the GPU time in the measurement, and in the draw time the
+    // load equalizer balances decomposed channels on
+    const seq::RenderContext& context = getRenderContext();
+    if( model.getNumLevels() > 1 || context.range != eq::Range::ALL ||
+        context.vp != eq::Viewport::FULL )
+    {
+        EQ_GL_CALL( glFinish( ));
+    }
+    _frameTime += _clock.getTimef() - startTime;
+    application.getStats().setParticles( _channelName, _drawnParticles,
+                                         _culledParticles );
+}
+
+void Renderer::_countParticles( const Model::Particles& particles )
+{
+    // the projection deactivates the particles outside of the frustum
+    const size_t drawn = std::count_if( particles.begin(), particles.end(),
+                                        []( const particle_sim& particle )
+                                        { return particle.active; });
+    _drawnParticles += drawn;
+    _culledParticles += particles.size() - drawn;
 }
 
 }
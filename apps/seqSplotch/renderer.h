@@ -30,6 +30,7 @@
 #define SEQ_SPLOTCH_RENDERER_H
 
 #include "application.h"
+#include "model.h"
 #include <seq/sequel.h>
 #include <eq/gl.h>
 
@@ -44,7 +45,7 @@ class Renderer : public seq::Renderer
 {
 public:
     Renderer( seq::Application& app );
-    virtual ~Renderer() {}
+    virtual ~Renderer();
 
 protected:
     bool init( co::Object* initData ) final;
@@ -55,9 +56,41 @@ protected:
     void destroyViewData( seq::ViewData* viewData ) final;
 
 private:
+    Model& _getModel();
+    std::pair< size_t, size_t > _getParts() const;
+    void _releaseModels();
+    bool _isLocalModel( const Model& model ) const;
+    uint32_t _getHiddenTypes() const;
+
     void _splotchRender();
+    void _renderSplotchImage( const seq::Vector2i& size,
+                              const eq::PixelViewport& region,
+                              std::vector< float >& pixels,
+                              std::vector< float >* otherPixels = nullptr );
+    void _drawPixels( const std::vector< float >& pixels,
+                      const seq::Vector2i& imageSize,
+                      const seq::Vector2i& size, const seq::Vector2i& offset );
+#ifndef CUDA
+    const Model::Particles& _getColorizedParticles();
+    void _splatColorized( arr2< COLOUR >& pic, arr2< COLOUR >* otherPic,
+                          const seq::Vector3f& origin,
+                          const seq::Vector3f& lookAt,
+                          const seq::Vector3f& up, float eyeOffset,
+                          const seq::Vector2i& offset );
+#endif
     void _gpuRender();
     void _osprayRender();
+    void _countParticles( const Model::Particles& particles );
+
+    std::string _getChannelName() const;
+    bool _startChannel();
+
+    void _updateFrameBudget();
+    bool _selectLevel( float frameTime, size_t frameParticles,
+                       float targetTime );
+    bool _selectResolution( float frameTime, float targetTime );
+    seq::Vector2i _getRenderSize() const;
+    void _setPixelZoom( const seq::Vector2i& size ) const;
 
     bool _loadShaders();
     bool _createBuffers();
@@ -68,7 +101,31 @@ private:
                         const seq::Vector2f& sampleOffset );
     void _blit( eq::util::FrameBufferObject* fbo );
 
-    lunchbox::Buffer< float > _pixels;
+    struct SplotchImage
+    {
+        const seq::ViewData* viewData;
+        eq::PixelViewport pvp;
+        eq::Eye eye;
+        float rangeStart;
+        uint64_t frame;
+
+        // camera and data of the last full render in pixels, of the region
+        // of the size x size image
+        seq::Vector2i size;
+        eq::PixelViewport region;
+        seq::Matrix4f modelView;
+        size_t modelRevision;
+        uint32_t hiddenTypes;
+        size_t level;
+        std::vector< float > pixels;
+        std::vector< float > warped;
+    };
+    std::vector< SplotchImage > _images;
+    SplotchImage& _getImage( const eq::PixelViewport& pvp, eq::Eye eye );
+    bool _canReproject( const SplotchImage& image,
+                        const seq::Matrix4f& modelView );
+    void _reproject( SplotchImage& image,
+                     const seq::Matrix4f& modelView );
 
     GLuint _particleShader;
     GLuint _blurShader;
@@ -81,9 +138,52 @@ private:
 
     GLuint _rectVBO;
 
-    size_t _gpuModelFrameIndex;
-    size_t _osprayModelFrameIndex;
+    const Model* _gpuModel;
+    size_t _gpuModelRevision;
+    uint32_t _gpuHiddenTypes;
+    const Model* _osprayModel;
+    size_t _osprayModelRevision;
+    uint32_t _osprayHiddenTypes;
     size_t _numParticles;
+    std::vector< size_t > _numLevelParticles;
+
+    lunchbox::Clock _clock;
+    lunchbox::uint128_t _frameID; // of the render context, see _startChannel
+    uint64_t _frameNumber;
+    std::vector< eq::Eye > _drawnChannels; // in the current pipe frame
+    seq::Matrix4f _previousModelMatrix;
+    bool _moving;
+    float _frameTime;
+    size_t _frameParticles;
+    size_t _frameChannels; // drawn in the previous pipe frame
+    size_t _drawnParticles; // of the current channel, reported to Stats
+    size_t _culledParticles;
+    size_t _level;
+    float _resolution;
+
+    const Model* _colorizedModel;
+    size_t _colorizedRevision;
+    size_t _colorizedLevel;
+    uint32_t _colorizedHiddenTypes;
+    Model::Particles _colorizedParticles;
+    Model::Particles _renderParticles; // projected in place, kept per pipe
+    Model::Particles _otherEyeParticles; // of a stereo pair
+
+    const size_t _index; // for the channel names
+    std::string _channelName;
+    bool _coresPartitioned; // OpenMP threads of this pipe thread
+
+    // the particles of each DB range drawn by this pipe, shared with the
+    // other pipes of the process
+    struct RangeModel
+    {
+        size_t first; // parts of the data, see Application::getNumParts()
+        size_t last;
+        std::shared_ptr< Model > model;
+        uint64_t frame; // the last pipe frame drawing it
+    };
+    std::string _modelURI;
+    std::vector< RangeModel > _models;
 
 #ifdef SEQSPLOTCH_USE_OSPRAY
     std::unique_ptr< OSPRayRenderer > _osprayRenderer;
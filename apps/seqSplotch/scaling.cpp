@@ -0,0 +1,271 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <climits>
+#include <cstdlib>
+#include <libgen.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Scaling harness: runs seqSplotchBench with an increasing number of local
+// render client processes, connected over loopback, and reports the speedup
+// over a single process and the compositing overhead per configuration.
+namespace
+{
+struct Result
+{
+    std::string renderer;
+    float frameTime;
+    float drawTime;
+};
+
+struct Configuration
+{
+    std::string decomposition;
+    size_t numClients;
+    std::vector< Result > results;
+};
+
+std::vector< std::string > _split( const std::string& list )
+{
+    std::vector< std::string > items;
+    std::stringstream stream( list );
+    std::string item;
+    while( std::getline( stream, item, ',' ))
+        items.push_back( item );
+    return items;
+}
+
+bool _run( std::vector< std::string > args )
+{
+    std::vector< char* > argv;
+    for( std::string& arg : args )
+        argv.push_back( &arg[0] );
+    argv.push_back( nullptr );
+
+    const pid_t pid = ::fork();
+    if( pid < 0 )
+        return false;
+    if( pid == 0 )
+    {
+        ::execv( argv[0], argv.data( ));
+        std::cerr << "Can't start " << args[0] << std::endl;
+        ::_exit( EXIT_FAILURE );
+    }
+
+    int status = 0;
+    if( ::waitpid( pid, &status, 0 ) != pid )
+        return false;
+    return WIFEXITED( status ) && WEXITSTATUS( status ) == EXIT_SUCCESS;
+}
+
+float _getValue( const std::string& line, const std::string& key )
+{
+    const size_t pos = line.find( "\"" + key + "\":" );
+    if( pos == std::string::npos )
+        return 0.f;
+    return std::strtof( line.c_str() + pos + key.length() + 3, nullptr );
+}
+
+// reads the lines written by seqSplotch::Benchmark
+std::vector< Result > _readResults( const std::string& filename )
+{
+    std::vector< Result > results;
+    std::ifstream file( filename.c_str( ));
+    std::string line;
+    while( std::getline( file, line ))
+    {
+        if( line.find( "\"name\":" ) != std::string::npos )
+        {
+            const size_t end = line.rfind( '"' );
+            const size_t start = line.rfind( '"', end - 1 ) + 1;
+            results.push_back( Result{ line.substr( start, end - start ),
+                                       0.f, 0.f });
+        }
+        else if( results.empty( ))
+            continue;
+        else if( line.find( "\"frameTime\":" ) != std::string::npos )
+            results.back().frameTime = _getValue( line, "mean" );
+        else if( line.find( "\"drawTime\":" ) != std::string::npos )
+            results.back().drawTime = _getValue( line, "drawTime" );
+    }
+    return results;
+}
+
+std::string _getBenchPath( const char* argv0 )
+{
+    char path[PATH_MAX];
+    if( !::realpath( argv0, path ))
+        return "seqSplotchBench";
+    return std::string( ::dirname( path )) + "/seqSplotchBench";
+}
+}
+
+int main( const int argc, char** argv )
+{
+    std::string bench = _getBenchPath( argv[0] );
+    std::string paramfile = "synthetic://plummer?particles=1e6";
+    std::vector< std::string > decompositions = { "2D", "DB", "STEREO" };
+    std::vector< std::string > clients = { "1", "3" };
+    std::string frames = "20";
+    std::string resolution = "1280x720";
+    std::string output;
+    bool balance = false;
+    float minEfficiency = 0.f;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+        if( arg == "--help" || arg == "-h" )
+        {
+            std::cout << "Usage: " << argv[0] << " [--paramfile uri] "
+                      << "[--clients n1,n2,...] "
+                      << "[--decompositions 2D,DB,STEREO] [--frames n] "
+                      << "[--resolution <width>x<height>] [--balance] "
+                      << "[--min-efficiency e] [--bench path] "
+                      << "[--output file]" << std::endl;
+            return EXIT_SUCCESS;
+        }
+        if( arg == "--balance" )
+        {
+            balance = true;
+            continue;
+        }
+        if( i + 1 >= argc )
+            continue;
+        if( arg == "--paramfile" )
+            paramfile = argv[++i];
+        else if( arg == "--clients" )
+            clients = _split( argv[++i] );
+        else if( arg == "--decompositions" )
+            decompositions = _split( argv[++i] );
+        else if( arg == "--frames" )
+            frames = argv[++i];
+        else if( arg == "--resolution" )
+            resolution = argv[++i];
+        else if( arg == "--min-efficiency" )
+            minEfficiency = std::stof( argv[++i] );
+        else if( arg == "--bench" )
+            bench = argv[++i];
+        else if( arg == "--output" )
+            output = argv[++i];
+    }
+
+    const std::string resultFile = "/tmp/seqSplotchScaling." +
+                                   std::to_string( ::getpid( )) + ".json";
+    std::vector< Configuration > configurations;
+    bool success = true;
+    for( const std::string& decomposition : decompositions )
+    {
+        // the single process of each decomposition is the baseline
+        std::vector< std::string > numClients = { "0" };
+        numClients.insert( numClients.end(), clients.begin(), clients.end( ));
+        for( const std::string& count : numClients )
+        {
+            std::vector< std::string > args = { bench,
+                "--paramfile", paramfile, "--clients", count,
+                "--decomposition", decomposition, "--resolution", resolution,
+                "--benchmark", resultFile, "--benchmark-frames", frames };
+            if( balance )
+                args.push_back( "--balance" );
+
+            std::cerr << decomposition << " with " << count
+                      << " render clients" << std::endl;
+            ::unlink( resultFile.c_str( ));
+            if( !_run( args ))
+            {
+                std::cerr << "  failed" << std::endl;
+                success = false;
+                continue;
+            }
+            configurations.push_back( Configuration{ decomposition,
+                std::stoul( count ), _readResults( resultFile )});
+        }
+    }
+    ::unlink( resultFile.c_str( ));
+
+    std::ofstream file;
+    if( !output.empty( ))
+        file.open( output.c_str( ));
+    std::ostream& os = output.empty() ? std::cout : file;
+
+    const Configuration* baseline = nullptr;
+    os << "{" << std::endl
+       << "  \"paramfile\": \"" << paramfile << "\"," << std::endl
+       << "  \"configurations\": [" << std::endl;
+    for( size_t i = 0; i < configurations.size(); ++i )
+    {
+        const Configuration& config = configurations[i];
+        if( config.numClients == 0 )
+            baseline = &config;
+        if( !baseline || baseline->decomposition != config.decomposition )
+            baseline = nullptr;
+
+        os << "    {" << std::endl
+           << "      \"decomposition\": \"" << config.decomposition << "\","
+           << std::endl
+           << "      \"clients\": " << config.numClients << "," << std::endl
+           << "      \"renderers\": [" << std::endl;
+        for( size_t j = 0; j < config.results.size(); ++j )
+        {
+            const Result& result = config.results[j];
+            float speedup = 0.f;
+            if( baseline && j < baseline->results.size() &&
+                result.frameTime > 0.f )
+            {
+                speedup = baseline->results[j].frameTime / result.frameTime;
+            }
+            const float efficiency = speedup / float( config.numClients + 1 );
+            if( baseline && efficiency < minEfficiency )
+                success = false;
+
+            // the frame time not spent drawing on the application node:
+            // readback, transfer and assembly of the client images
+            os << "        { \"name\": \"" << result.renderer << "\""
+               << ", \"frameTime\": " << result.frameTime
+               << ", \"drawTime\": " << result.drawTime
+               << ", \"compositingOverhead\": "
+               << std::max( result.frameTime - result.drawTime, 0.f )
+               << ", \"speedup\": " << speedup
+               << ", \"efficiency\": " << efficiency << " }"
+               << ( j + 1 < config.results.size() ? "," : "" ) << std::endl;
+        }
+        os << "      ]" << std::endl
+           << "    }" << ( i + 1 < configurations.size() ? "," : "" )
+           << std::endl;
+    }
+    os << "  ]" << std::endl << "}" << std::endl;
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,141 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sceneCache.h"
+
+#include "kernels.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace seqSplotch
+{
+
+SceneCache::SceneCache( const servus::URI& uri )
+    : _params( std::to_string( uri ), false )
+    , _sceneMaker( new sceneMaker( _params ))
+    , _nextIndex( 0 )
+    , _numScenes( std::numeric_limits< size_t >::max( ))
+    , _numReaders( 0 )
+    , _sceneSize( 0 )
+{
+}
+
+void SceneCache::addReader()
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    ++_numReaders;
+}
+
+void SceneCache::removeReader()
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    --_numReaders;
+}
+
+bool SceneCache::getScene( const size_t index, const seq::Vector2f& range,
+                           FramePool::Particles& particles,
+                           vec3& cameraPosition, vec3& lookAt, vec3& up )
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    auto scene = std::find_if( _scenes.begin(), _scenes.end(),
+                               [&]( const Scene& candidate )
+                               { return candidate.index == index; });
+    Scene* loaded = scene == _scenes.end() ? _load( index ) : &*scene;
+    if( !loaded )
+        return false;
+
+    const FramePool::Particles& source = loaded->particles;
+    const size_t first = size_t( range.x() * float( source.size( )));
+    const size_t last = range.y() >= 1.f ? source.size() :
+                        std::max( first,
+                                  size_t( range.y() * float( source.size( ))));
+    copyParticles( source.data() + first, last - first, particles );
+    cameraPosition = loaded->cameraPosition;
+    lookAt = loaded->lookAt;
+    up = loaded->up;
+
+    if( loaded->readers > 0 && --loaded->readers == 0 )
+    {
+        auto done = std::find_if( _scenes.begin(), _scenes.end(),
+                                  [&]( const Scene& candidate )
+                                  { return candidate.index == index; });
+        _free.swap( done->particles );
+        _scenes.erase( done );
+    }
+    return true;
+}
+
+SceneCache::Scene* SceneCache::_load( const size_t index )
+{
+    if( index >= _numScenes )
+        return nullptr;
+
+    Tracer::Span span( "SceneCache::load" );
+    if( index < _nextIndex )
+    {
+        _sceneMaker.reset( new sceneMaker( _params ));
+        _nextIndex = 0;
+    }
+
+    // the current and the prefetched snapshot, the oldest gives its buffer
+    if( _scenes.size() >= 2 )
+    {
+        _free.swap( _scenes.front().particles );
+        _scenes.pop_front();
+    }
+    _scenes.push_back( Scene( ));
+    Scene& scene = _scenes.back();
+    scene.particles.swap( _free );
+    FramePool::reserve( scene.particles, _sceneSize );
+    scene.readers = _numReaders;
+
+    // the readers are sequential, skipped snapshots are read and dropped
+    for( ; _nextIndex <= index; ++_nextIndex )
+    {
+        FramePool::Particles points;
+        vec3 centerPos;
+        std::string outfile;
+        scene.particles.clear();
+        if( !_sceneMaker->getNextScene( scene.particles, points,
+                                        scene.cameraPosition, centerPos,
+                                        scene.lookAt, scene.up, outfile ))
+        {
+            _numScenes = _nextIndex;
+            _free.swap( scene.particles );
+            _scenes.pop_back();
+            return nullptr;
+        }
+    }
+    scene.index = index;
+    _sceneSize = scene.particles.size();
+    return &scene;
+}
+
+}
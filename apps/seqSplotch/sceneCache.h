@@ -0,0 +1,100 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_SCENECACHE_H
+#define SEQ_SPLOTCH_SCENECACHE_H
+
+#include "framePool.h"
+
+#include <seq/sequel.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include <splotch/scenemaker.h>
+
+namespace seqSplotch
+{
+
+/**
+ * The snapshots of a Splotch parameter file, read once for all models of a
+ * node which hold a range of their particles.
+ *
+ * The Splotch readers have no partial loading. Without the cache each range
+ * model would read the whole snapshot to copy its part. A snapshot is kept
+ * until all readers have copied their range, at most the current and the
+ * prefetched one. Thread-safe, readers load from their prefetch threads.
+ */
+class SceneCache
+{
+public:
+    explicit SceneCache( const servus::URI& uri );
+
+    /** Count a model which reads each snapshot, until removeReader(). */
+    void addReader();
+    void removeReader();
+
+    /**
+     * Copy the given fraction of the particles of a snapshot, reading it if
+     * it is not cached. The data is read from the start again to go back to
+     * an earlier snapshot.
+     *
+     * @return false past the last snapshot.
+     */
+    bool getScene( size_t index, const seq::Vector2f& range,
+                   FramePool::Particles& particles, vec3& cameraPosition,
+                   vec3& lookAt, vec3& up );
+
+private:
+    struct Scene
+    {
+        size_t index;
+        FramePool::Particles particles;
+        vec3 cameraPosition;
+        vec3 lookAt;
+        vec3 up;
+        size_t readers; // which did not copy their range yet
+    };
+
+    Scene* _load( size_t index );
+
+    std::mutex _mutex;
+    paramfile _params;
+    std::unique_ptr< sceneMaker > _sceneMaker;
+    size_t _nextIndex; // of _sceneMaker
+    size_t _numScenes; // known once the end was read
+    size_t _numReaders;
+    size_t _sceneSize; // of the last snapshot, reserved for the next one
+    std::deque< Scene > _scenes;
+    FramePool::Particles _free; // buffer of the last dropped scene
+};
+
+}
+
+#endif
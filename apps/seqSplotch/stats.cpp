@@ -0,0 +1,171 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stats.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace seqSplotch
+{
+
+const char* Stats::getName( const Stage stage )
+{
+    switch( stage )
+    {
+    case STAGE_FRAME:
+        return "frame";
+    case STAGE_LOAD:
+        return "load";
+    case STAGE_COLORIZE:
+        return "colorize";
+    case STAGE_UPLOAD:
+        return "upload";
+    case STAGE_RENDER:
+        return "render";
+    case STAGE_POSTPROCESS:
+        return "postprocess";
+    case STAGE_BLIT:
+        return "blit";
+    case STAGE_OSPRAY_BUILD:
+        return "osprayBuild";
+    case STAGE_OSPRAY_RENDER:
+        return "osprayRender";
+    case STAGE_ALL:
+        break;
+    }
+    return "unknown";
+}
+
+Stats::Timer::Timer( Stats* stats, const std::string& channel,
+                     const Stage stage )
+    : _stats( stats )
+    , _channel( channel )
+    , _stage( stage )
+    , _span( getName( stage ))
+{
+}
+
+Stats::Timer::~Timer()
+{
+    if( _stats )
+        _stats->add( _channel, _stage, _clock.getTimef( ));
+}
+
+Stats::Stats( const size_t numSamples )
+    : _numSamples( std::max( numSamples, size_t( 1 )))
+{
+}
+
+void Stats::add( const std::string& channel, const Stage stage,
+                 const float milliseconds )
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    Samples& samples = _channels[channel].stages[stage];
+    if( samples.values.size() < _numSamples )
+    {
+        samples.values.push_back( milliseconds );
+        return;
+    }
+    samples.values[samples.next] = milliseconds;
+    samples.next = ( samples.next + 1 ) % _numSamples;
+}
+
+void Stats::setParticles( const std::string& channel, const size_t drawn,
+                          const size_t culled )
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    Channel& entry = _channels[channel];
+    entry.drawn = drawn;
+    entry.culled = culled;
+}
+
+float Stats::getMedian( const Stage stage ) const
+{
+    std::vector< float > values = getSamples( stage );
+    if( values.empty( ))
+        return 0.f;
+
+    auto median = values.begin() + values.size() / 2;
+    std::nth_element( values.begin(), median, values.end( ));
+    return *median;
+}
+
+std::vector< float > Stats::getSamples( const Stage stage ) const
+{
+    std::vector< float > values;
+    std::lock_guard< std::mutex > lock( _mutex );
+    for( const auto& channel : _channels )
+    {
+        const std::vector< float >& samples =
+            channel.second.stages[stage].values;
+        values.insert( values.end(), samples.begin(), samples.end( ));
+    }
+    return values;
+}
+
+void Stats::clear()
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    _channels.clear();
+}
+
+std::string Stats::_toJSON() const
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    std::ostringstream os;
+    os << "{\"samples\":" << _numSamples << ",\"channels\":{";
+    for( auto i = _channels.begin(); i != _channels.end(); ++i )
+    {
+        os << ( i == _channels.begin() ? "" : "," ) << "\"" << i->first
+           << "\":{";
+        bool first = true;
+        for( size_t stage = 0; stage < STAGE_ALL; ++stage )
+        {
+            std::vector< float > values = i->second.stages[stage].values;
+            if( values.empty( ))
+                continue;
+
+            std::sort( values.begin(), values.end( ));
+            const size_t p95 = std::min( size_t( .95f * values.size( )),
+                                         values.size() - 1 );
+            os << ( first ? "" : "," ) << "\"" << getName( Stage( stage ))
+               << "\":{\"count\":" << values.size()
+               << ",\"p50\":" << values[values.size() / 2]
+               << ",\"p95\":" << values[p95]
+               << ",\"max\":" << values.back() << "}";
+            first = false;
+        }
+        os << ( first ? "" : "," ) << "\"particles\":{\"drawn\":"
+           << i->second.drawn << ",\"culled\":" << i->second.culled << "}}";
+    }
+    os << "}}";
+    return os.str();
+}
+
+}
@@ -0,0 +1,133 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_STATS_H
+#define SEQ_SPLOTCH_STATS_H
+
+#include "tracer.h"
+
+#include <lunchbox/clock.h>
+#include <servus/serializable.h>
+
+#include <array>
+#include <map>
+#include <mutex>
+
+namespace seqSplotch
+{
+
+/**
+ * Rolling per-channel timings of the frame stages, and the particles drawn
+ * and culled in the last frame of each channel.
+ *
+ * Samples are recorded from the pipe threads, the JSON representation with
+ * the p50, p95 and max of the last samples of each stage is served on the
+ * seqsplotch/stats endpoint of the http server.
+ */
+class Stats : public servus::Serializable
+{
+public:
+    enum Stage
+    {
+        STAGE_FRAME,
+        STAGE_LOAD,
+        STAGE_COLORIZE,
+        STAGE_UPLOAD,
+        STAGE_RENDER,
+        STAGE_POSTPROCESS,
+        STAGE_BLIT,
+        STAGE_OSPRAY_BUILD,
+        STAGE_OSPRAY_RENDER,
+        STAGE_ALL
+    };
+
+    /**
+     * Records the lifetime of the timer as a sample of the stage, and as a
+     * span when tracing.
+     */
+    class Timer
+    {
+    public:
+        Timer( Stats* stats, const std::string& channel, Stage stage );
+        ~Timer();
+
+    private:
+        Stats* const _stats;
+        const std::string& _channel;
+        const Stage _stage;
+        const Tracer::Span _span;
+        lunchbox::Clock _clock;
+    };
+
+    explicit Stats( size_t numSamples = 256 );
+
+    static const char* getName( Stage stage );
+
+    /** Add a sample in milliseconds, thread safe. */
+    void add( const std::string& channel, Stage stage, float milliseconds );
+
+    /** Set the particles of the last frame of a channel, thread safe. */
+    void setParticles( const std::string& channel, size_t drawn,
+                       size_t culled );
+
+    /** @return the median of a stage over all channels, 0 without samples. */
+    float getMedian( Stage stage ) const;
+
+    /** @return the samples of a stage of all channels, unordered. */
+    std::vector< float > getSamples( Stage stage ) const;
+
+    /** Drop all samples and particle counts. */
+    void clear();
+
+    std::string getTypeName() const final { return "seqSplotch::Stats"; }
+
+private:
+    struct Samples
+    {
+        Samples() : next( 0 ) {}
+        std::vector< float > values;
+        size_t next;
+    };
+    struct Channel
+    {
+        Channel() : drawn( 0 ), culled( 0 ) {}
+        std::array< Samples, STAGE_ALL > stages;
+        size_t drawn;
+        size_t culled;
+    };
+
+    std::string _toJSON() const final;
+
+    const size_t _numSamples;
+    mutable std::mutex _mutex;
+    std::map< std::string, Channel > _channels;
+};
+
+}
+
+#endif
@@ -0,0 +1,373 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "synthetic.h"
+
+#include "tracer.h"
+
+#include <lunchbox/log.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+namespace seqSplotch
+{
+namespace
+{
+const size_t _chunkSize = 65536;
+const float _smoothing = 1.2f; // in units of the local particle spacing
+const float _concentration = 10.f;
+const size_t _numNodes = 32;
+const float _filamentWidth = .02f;
+
+struct Sample
+{
+    float x, y, z;
+    float density; // fraction of the particles per unit volume
+};
+
+struct Edge
+{
+    vec3 a, b;
+};
+
+float _uniform( std::mt19937& rng )
+{
+    return std::uniform_real_distribution< float >( 0.f, 1.f )( rng );
+}
+
+void _setDirection( std::mt19937& rng, const float radius, Sample& sample )
+{
+    const float cosTheta = 2.f * _uniform( rng ) - 1.f;
+    const float sinTheta = std::sqrt( 1.f - cosTheta * cosTheta );
+    const float phi = 2.f * float( M_PI ) * _uniform( rng );
+    sample.x = radius * sinTheta * std::cos( phi );
+    sample.y = radius * sinTheta * std::sin( phi );
+    sample.z = radius * cosTheta;
+}
+
+// unit mass and scale radius, tail truncated at ~40 scale radii
+Sample _samplePlummer( std::mt19937& rng )
+{
+    const float u = std::max( std::min( _uniform( rng ), .999f ), 1e-6f );
+    const float radius = 1.f / std::sqrt( std::pow( u, -2.f / 3.f ) - 1.f );
+
+    Sample sample;
+    _setDirection( rng, radius, sample );
+    sample.density = 3.f / ( 4.f * float( M_PI )) *
+                     std::pow( 1.f + radius * radius, -2.5f );
+    return sample;
+}
+
+float _getNFWMass( const float x )
+{
+    return std::log( 1.f + x ) - x / ( 1.f + x );
+}
+
+// unit scale radius, truncated at the concentration radius
+Sample _sampleNFW( std::mt19937& rng )
+{
+    const float totalMass = _getNFWMass( _concentration );
+    const float mass = _uniform( rng ) * totalMass;
+    float low = 0.f;
+    float high = _concentration;
+    for( size_t i = 0; i < 32; ++i )
+    {
+        const float mid = .5f * ( low + high );
+        if( _getNFWMass( mid ) < mass )
+            low = mid;
+        else
+            high = mid;
+    }
+    const float radius = std::max( .5f * ( low + high ), 1e-3f );
+
+    Sample sample;
+    _setDirection( rng, radius, sample );
+    sample.density = 1.f / ( 4.f * float( M_PI ) * totalMass * radius *
+                             ( 1.f + radius ) * ( 1.f + radius ));
+    return sample;
+}
+
+Sample _sampleBox( std::mt19937& rng )
+{
+    Sample sample;
+    sample.x = 2.f * _uniform( rng ) - 1.f;
+    sample.y = 2.f * _uniform( rng ) - 1.f;
+    sample.z = 2.f * _uniform( rng ) - 1.f;
+    sample.density = 1.f / 8.f;
+    return sample;
+}
+
+// Gaussian tubes along the edges to the nearest neighbours of random nodes
+std::vector< Edge > _createFilaments( const uint32_t seed )
+{
+    std::mt19937 rng( seed );
+    std::vector< vec3 > nodes( _numNodes );
+    for( vec3& node : nodes )
+        node = vec3( 2.f * _uniform( rng ) - 1.f, 2.f * _uniform( rng ) - 1.f,
+                     2.f * _uniform( rng ) - 1.f );
+
+    std::vector< Edge > edges;
+    for( size_t i = 0; i < nodes.size(); ++i )
+    {
+        std::vector< std::pair< float, size_t >> neighbours;
+        for( size_t j = i + 1; j < nodes.size(); ++j )
+            neighbours.push_back( std::make_pair(
+                                      ( nodes[j] - nodes[i] ).SquaredLength(),
+                                      j ));
+        std::sort( neighbours.begin(), neighbours.end( ));
+        for( size_t j = 0; j < std::min( neighbours.size(), size_t( 3 )); ++j )
+            edges.push_back( Edge{ nodes[i], nodes[neighbours[j].second] });
+    }
+    return edges;
+}
+
+// @return false if the query item is not a positive number, value is kept
+// if there is no such item
+bool _getQuery( const servus::URI& uri, const std::string& name,
+                double& value )
+{
+    const auto i = uri.findQuery( name );
+    if( i == uri.queryEnd( ))
+        return true;
+
+    char* end = nullptr;
+    const double number = std::strtod( i->second.c_str(), &end ); // 1e9
+    if( i->second.empty() || *end != '\0' || number < 0. )
+    {
+        LBERROR << "Invalid " << name << " '" << i->second << "' in " << uri
+                << std::endl;
+        return false;
+    }
+    value = number;
+    return true;
+}
+
+Sample _sampleFilament( std::mt19937& rng, const std::vector< Edge >& edges )
+{
+    const Edge& edge = edges[std::min( size_t( _uniform( rng ) * edges.size( )),
+                                       edges.size() - 1 )];
+    const float t = _uniform( rng );
+    std::normal_distribution< float > scatter( 0.f, _filamentWidth );
+    const vec3 position = edge.a + ( edge.b - edge.a ) * t;
+    const float length = std::max(( edge.b - edge.a ).Length(), 1e-3f );
+
+    Sample sample;
+    sample.x = position.x + scatter( rng );
+    sample.y = position.y + scatter( rng );
+    sample.z = position.z + scatter( rng );
+    sample.density = 1.f / ( float( edges.size( )) * length * 2.f *
+                             float( M_PI ) * _filamentWidth * _filamentWidth );
+    return sample;
+}
+}
+
+SyntheticSource::SyntheticSource( const servus::URI& uri )
+    : _distribution( PLUMMER )
+    , _numParticles( 1000000 )
+    , _seed( 0 )
+    , _numFrames( 1 )
+    , _frame( 0 )
+    , _rangeStart( 0.f )
+    , _rangeEnd( 1.f )
+    , _valid( true )
+{
+    const std::string& distribution = uri.getHost();
+    if( distribution == "plummer" )
+        _distribution = PLUMMER;
+    else if( distribution == "nfw" )
+        _distribution = NFW;
+    else if( distribution == "box" )
+        _distribution = BOX;
+    else if( distribution == "filaments" )
+        _distribution = FILAMENTS;
+    else
+    {
+        LBERROR << "Unknown synthetic distribution '" << distribution
+                << "' in " << uri << std::endl;
+        _valid = false;
+        return;
+    }
+
+    double numParticles = double( _numParticles );
+    double seed = _seed;
+    double numFrames = double( _numFrames );
+    if( !_getQuery( uri, "particles", numParticles ) ||
+        !_getQuery( uri, "seed", seed ) ||
+        !_getQuery( uri, "frames", numFrames ))
+    {
+        _valid = false;
+        return;
+    }
+    _numParticles = size_t( numParticles );
+    _seed = uint32_t( seed );
+    _numFrames = std::max( size_t( numFrames ), size_t( 1 ));
+}
+
+bool SyntheticSource::isSynthetic( const servus::URI& uri )
+{
+    return uri.getScheme() == "synthetic";
+}
+
+bool SyntheticSource::isValid() const
+{
+    return _valid;
+}
+
+void SyntheticSource::setRange( const float start, const float end )
+{
+    _rangeStart = std::max( 0.f, std::min( start, 1.f ));
+    _rangeEnd = std::max( _rangeStart, std::min( end, 1.f ));
+}
+
+size_t SyntheticSource::getNumParticles() const
+{
+    if( !_valid )
+        return 0;
+    const size_t last = _rangeEnd >= 1.f ? _numParticles :
+                        size_t( _rangeEnd * float( _numParticles ));
+    return last - _getFirst();
+}
+
+size_t SyntheticSource::_getFirst() const
+{
+    return size_t( _rangeStart * float( _numParticles ));
+}
+
+bool SyntheticSource::getNextScene( Particles& particles, vec3& cameraPosition,
+                                    vec3& lookAt, vec3& up )
+{
+    if( !_valid || _frame >= _numFrames )
+        return false;
+
+    const std::vector< Edge > edges = _distribution == FILAMENTS ?
+                                      _createFilaments( _seed ) :
+                                      std::vector< Edge >();
+
+    // differential rotation around z, a quarter turn of the core per sequence
+    const float time = float( _frame ) / float( _numFrames );
+
+    // particle_sim does not initialize, the pages are first touched by the
+    // threads generating them. Static chunks put them on the NUMA node of the
+    // thread which projects them later.
+    const size_t first = _getFirst();
+    const size_t last = first + getNumParticles();
+    particles.resize( last - first );
+    const int64_t firstChunk = first / _chunkSize;
+    const int64_t lastChunk = ( last + _chunkSize - 1 ) / _chunkSize;
+
+#pragma omp parallel for schedule( static )
+    for( int64_t chunk = firstChunk; chunk < lastChunk; ++chunk )
+    {
+        Tracer::Span span( "SyntheticSource::generate" );
+
+        // one generator per chunk: same particles for any thread count
+        std::seed_seq seed{ _seed, uint32_t( chunk ), uint32_t( chunk >> 32 )};
+        std::mt19937 rng( seed );
+
+        const size_t begin = chunk * _chunkSize;
+        const size_t end = std::min( begin + _chunkSize, _numParticles );
+        for( size_t i = begin; i < end; ++i )
+        {
+            Sample sample;
+            switch( _distribution )
+            {
+            case PLUMMER:
+                sample = _samplePlummer( rng );
+                break;
+            case NFW:
+                sample = _sampleNFW( rng );
+                break;
+            case BOX:
+                sample = _sampleBox( rng );
+                break;
+            case FILAMENTS:
+            default:
+                sample = _sampleFilament( rng, edges );
+                break;
+            }
+            if( i < first || i >= last ) // sampled to keep the generator in sync
+                continue;
+
+            const float radius = std::sqrt( sample.x * sample.x +
+                                            sample.y * sample.y );
+            const float angle = .5f * float( M_PI ) * time / ( .5f + radius );
+            const float cosAngle = std::cos( angle );
+            const float sinAngle = std::sin( angle );
+            const float density = sample.density * float( _numParticles );
+
+            particle_sim& particle = particles[i - first];
+            particle.x = sample.x * cosAngle - sample.y * sinAngle;
+            particle.y = sample.x * sinAngle + sample.y * cosAngle;
+            particle.z = sample.z;
+            particle.r = std::min( _smoothing * std::pow( density, -1.f / 3.f ),
+                                   1.f );
+            particle.I = 1.f;
+            particle.e = COLOUR( std::max( 0.f, std::min( 1.f,
+                             ( std::log10( sample.density ) + 6.f ) / 8.f )),
+                                 0.f, 0.f );
+            particle.type = 0;
+            particle.active = true;
+        }
+    }
+
+    float distance = 4.f;
+    switch( _distribution )
+    {
+    case PLUMMER:
+        distance = 10.f;
+        break;
+    case NFW:
+        distance = 2.5f * _concentration;
+        break;
+    default:
+        break;
+    }
+    cameraPosition = vec3( 0.f, 0.f, distance );
+    lookAt = vec3( 0.f, 0.f, 0.f );
+    up = vec3( 0.f, 1.f, 0.f );
+
+    ++_frame;
+    return true;
+}
+
+COLOURMAP SyntheticSource::getColorMap()
+{
+    COLOURMAP colorMap;
+    colorMap.addVal( 0.f, COLOUR( 0.f, 0.f, .2f ));
+    colorMap.addVal( .35f, COLOUR( .6f, 0.f, .4f ));
+    colorMap.addVal( .6f, COLOUR( 1.f, .4f, 0.f ));
+    colorMap.addVal( .85f, COLOUR( 1.f, .9f, .3f ));
+    colorMap.addVal( 1.f, COLOUR( 1.f, 1.f, 1.f ));
+    colorMap.sortMap();
+    return colorMap;
+}
+
+}
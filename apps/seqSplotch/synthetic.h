@@ -0,0 +1,99 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_SYNTHETIC_H
+#define SEQ_SPLOTCH_SYNTHETIC_H
+
+#include <servus/uri.h>
+#include <splotch/splotchutils.h>
+
+namespace seqSplotch
+{
+
+/**
+ * Generates particle frames from an analytic distribution instead of reading
+ * simulation snapshots.
+ *
+ * The URI has the form synthetic://<distribution>?particles=<n>&seed=<s>&
+ * frames=<n>, with the distribution being one of plummer, nfw, box or
+ * filaments. Frames show the same particles in differential rotation, so
+ * particle i of all frames is the same particle.
+ */
+class SyntheticSource
+{
+public:
+    typedef std::vector< particle_sim > Particles;
+
+    explicit SyntheticSource( const servus::URI& uri );
+
+    /** @return true if the URI describes a synthetic dataset. */
+    static bool isSynthetic( const servus::URI& uri );
+
+    /** @return false if the URI has an unknown distribution or bad values. */
+    bool isValid() const;
+
+    /**
+     * Generate only the given fraction of the particles of each frame. They
+     * are the same particles as in the complete frame.
+     */
+    void setRange( float start, float end );
+
+    /** @return the number of particles of each frame in the range. */
+    size_t getNumParticles() const;
+
+    /** Fill the next frame, @return false after the last frame. */
+    bool getNextScene( Particles& particles, vec3& cameraPosition,
+                       vec3& lookAt, vec3& up );
+
+    /** @return a default colormap for the generated colour values. */
+    static COLOURMAP getColorMap();
+
+private:
+    enum Distribution
+    {
+        PLUMMER,
+        NFW,
+        BOX,
+        FILAMENTS
+    };
+
+    size_t _getFirst() const;
+
+    Distribution _distribution;
+    size_t _numParticles;
+    uint32_t _seed;
+    size_t _numFrames;
+    size_t _frame;
+    float _rangeStart;
+    float _rangeEnd;
+    bool _valid;
+};
+
+}
+
+#endif
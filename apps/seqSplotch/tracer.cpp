@@ -0,0 +1,161 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "tracer.h"
+
+#include <lunchbox/log.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <unistd.h>
+
+namespace seqSplotch
+{
+namespace
+{
+struct Event
+{
+    const char* name;
+    uint64_t start;
+    uint64_t duration;
+};
+
+struct ThreadBuffer
+{
+    size_t thread;
+    std::vector< Event > events;
+    size_t dropped;
+};
+
+const size_t _maxEvents = 1 << 20; // 24 MB per thread
+
+std::atomic< bool > _enabled( false );
+std::string _filename;
+std::mutex _mutex;
+std::vector< std::unique_ptr< ThreadBuffer >> _buffers;
+thread_local ThreadBuffer* _buffer = nullptr;
+
+uint64_t _now()
+{
+    return std::chrono::duration_cast< std::chrono::microseconds >(
+               std::chrono::steady_clock::now().time_since_epoch( )).count();
+}
+
+// buffers stay owned here so events of finished threads are kept
+ThreadBuffer& _getBuffer()
+{
+    if( !_buffer )
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+        _buffers.emplace_back( new ThreadBuffer );
+        _buffer = _buffers.back().get();
+        _buffer->thread = _buffers.size();
+        _buffer->dropped = 0;
+        _buffer->events.reserve( 4096 );
+    }
+    return *_buffer;
+}
+}
+
+void Tracer::start( const std::string& filename )
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    _filename = filename;
+    for( auto& buffer : _buffers )
+    {
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
+    _enabled = true;
+}
+
+void Tracer::stop()
+{
+    if( !_enabled.exchange( false ))
+        return;
+
+    std::lock_guard< std::mutex > lock( _mutex );
+    std::ofstream file( _filename.c_str( ));
+    if( !file )
+    {
+        LBWARN << "Can't write trace to " << _filename << std::endl;
+        return;
+    }
+
+    const pid_t pid = ::getpid();
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    size_t dropped = 0;
+    for( const auto& buffer : _buffers )
+    {
+        dropped += buffer->dropped;
+        for( const Event& event : buffer->events )
+        {
+            file << ( first ? "" : "," ) << std::endl
+                 << "{\"name\":\"" << event.name << "\",\"ph\":\"X\","
+                 << "\"ts\":" << event.start << ",\"dur\":" << event.duration
+                 << ",\"pid\":" << pid << ",\"tid\":" << buffer->thread << "}";
+            first = false;
+        }
+    }
+    file << std::endl << "]}" << std::endl;
+    LBINFO << "Wrote trace to " << _filename << std::endl;
+    if( dropped > 0 )
+        LBWARN << "Dropped " << dropped << " trace events of full thread "
+               << "buffers" << std::endl;
+}
+
+bool Tracer::isEnabled()
+{
+    return _enabled;
+}
+
+Tracer::Span::Span( const char* name )
+    : _name( name )
+    , _start( _enabled ? _now() : 0 )
+{
+}
+
+Tracer::Span::~Span()
+{
+    if( !_enabled || _start == 0 )
+        return;
+    const uint64_t end = _now();
+    ThreadBuffer& buffer = _getBuffer();
+    if( buffer.events.size() < _maxEvents )
+        buffer.events.push_back( Event{ _name, _start, end - _start });
+    else
+        ++buffer.dropped;
+}
+
+}
@@ -0,0 +1,73 @@
+
+/* Copyright (c) 2026, agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEQ_SPLOTCH_TRACER_H
+#define SEQ_SPLOTCH_TRACER_H
+
+#include <cstdint>
+#include <string>
+
+namespace seqSplotch
+{
+
+/**
+ * Opt-in recorder of timed spans, written in the Chrome trace event format
+ * readable by chrome://tracing and Perfetto.
+ *
+ * Every thread appends to its own buffer without locking, the buffers are
+ * only read by stop() which must be called once all traced threads are done.
+ * A buffer holds at most a million events, later ones of its thread are
+ * dropped and counted.
+ */
+class Tracer
+{
+public:
+    /** Start recording, the events are written to filename on stop(). */
+    static void start( const std::string& filename );
+
+    /** Stop recording and write the trace. */
+    static void stop();
+
+    static bool isEnabled();
+
+    /** Records its lifetime on the calling thread, name must be static. */
+    class Span
+    {
+    public:
+        explicit Span( const char* name );
+        ~Span();
+
+    private:
+        const char* const _name;
+        const uint64_t _start;
+    };
+};
+
+}
+
+#endif
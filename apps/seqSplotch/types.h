@@ -32,9 +32,18 @@
 namespace seqSplotch
 {
 
+class Benchmark;
+class CameraPath;
 class Model;
+class SceneCache;
+class Stats;
 class ViewData;
 
+namespace serializable
+{
+class FrameData;
+}
+
 enum Camera
 {
     CAM_PERSPECTIVE,
@@ -30,6 +30,8 @@
 
 #include "model.h"
 
+#include "serializables/frameData.h"
+
 #include <eq/view.h>
 
 namespace seqSplotch
@@ -38,14 +40,17 @@ namespace seqSplotch
 ViewData::ViewData( seq::View& view )
     : Super( view )
     , _model( nullptr )
+    , _frameData( nullptr )
     , _view( view )
 {
 }
 
-ViewData::ViewData( seq::View& view, Model* model )
+ViewData::ViewData( seq::View& view, Model* model,
+                    serializable::FrameData* frameData )
     : Super( view )
     , _initialModelMatrix( model->getModelMatrix( ))
     , _model( model )
+    , _frameData( frameData )
     , _view( view )
 {
     view.setModelUnit( EQ_MM * 10.f );
@@ -76,6 +81,11 @@ Camera ViewData::getCamera() const
     return getOrtho() ? CAM_ORTHO : CAM_PERSPECTIVE;
 }
 
+seq::View& ViewData::getView()
+{
+    return _view;
+}
+
 bool ViewData::handleEvent( const eq::EventType type,
                             const seq::KeyEvent& keyEvent )
 {
@@ -89,6 +99,10 @@ bool ViewData::handleEvent( const eq::EventType type,
             return true;
         case 'n':
             _model->loadNextFrame();
+            _frameData->setBlend( 0.f );
+            return true;
+        case 'p':
+            _frameData->setPlaying( !_frameData->getPlaying( ));
             return true;
         case 'r':
             setRenderer(serializable::RendererType((int(getRenderer())+1) % (int(serializable::RendererType::OSPRAY)+1)));
@@ -96,6 +110,17 @@ bool ViewData::handleEvent( const eq::EventType type,
         case 'b':
             setBlur( !getBlur( ));
             return true;
+        case 'd':
+            setDynamicResolution( !getDynamicResolution( ));
+            return true;
+        case 'w':
+            setReprojection( !getReprojection( ));
+            return true;
+        case '1': case '2': case '3': case '4': case '5':
+        case '6': case '7': case '8': case '9':
+            // toggle the particle type, the model has it in separate ranges
+            setHiddenTypes( getHiddenTypes() ^ ( 1u << ( keyEvent.key - '1' )));
+            return true;
         case '+':
             setBlurStrength( getBlurStrength() + 0.05f );
             return true;
@@ -43,17 +43,20 @@ class ViewData : public Super
 {
 public:
     explicit ViewData( seq::View& view );
-    ViewData( seq::View& view, Model* model );
+    ViewData( seq::View& view, Model* model,
+              serializable::FrameData* frameData );
     ~ViewData();
 
     bool handleEvent( eq::EventType type, const seq::KeyEvent& keyEvent ) final;
     seq::Vector2f getFOV() const;
     Camera getCamera() const;
+    seq::View& getView();
 
 private:
     void notifyChanged() final;
     const seq::Matrix4f _initialModelMatrix;
     Model* _model;
+    serializable::FrameData* _frameData;
     seq::View& _view;
 };
 